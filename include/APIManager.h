@@ -8,7 +8,18 @@
 
 // Import package for Data Collections
 #include <ArrayList.h>
+#include <FlatMap.h>
 #include <HashMap.h>
+#include <StaticMap.h>
+
+// Import type traits for checking the column map types
+#include <TypeTraits.h>
+
+// Import package for the interned column names and the column maps
+#include <Columns.h>
+
+// Import package for Member Record
+#include <MemberRecord.h>
 
 /**
  * @brief PostmanAPI class for managing API requests to the Postman API.
@@ -26,12 +37,21 @@ class PostmanAPI {
   String response;
   // Response code from the API
   int responseCode;
+  // ID of the row created by the last create request
+  String createdId;
   // HTTP Client for making requests
   HTTPClient httpClient;
   // WiFi Client for secure connections
   // This client is used for secure connections (HTTPS)
   WiFiClientSecure client;
 
+  bool createFromStream(String gateway, Stream &body, size_t length);
+  bool checkCreateResponse();
+  ColumnMap readColumns(String gateway, String cardUID, const Column *columns,
+                        size_t count);
+  bool updateFromStream(String gateway, String cardUID, Stream &body,
+                        size_t length);
+
   public:
   // Constructor of PostmanAPI class
   PostmanAPI(const WiFiClientSecure &client, const String &url);
@@ -41,17 +61,70 @@ class PostmanAPI {
   String getUrl() const;
   String getResponse() const;
   int getResponseCode() const;
+  String getCreatedId() const;
+
+  bool createData(String gateway, const JsonDocument &jsonData);
+
+  /**
+   * @brief Creates new data in the Supabase database from a map.
+   * The map is streamed as the JSON request body with a known length,
+   * without building a JsonDocument or a String of it. HTTPClient still
+   * copies the body through its send buffer, up to 1460 bytes at a time.
+   *
+   * @param gateway The API endpoint for the specific gateway.
+   * @param data A HashMap or StaticMap of the columns to create.
+   * @return True if the data was created successfully, false otherwise.
+   */
+  template <typename Map> bool createData(String gateway, const Map &data) {
+    static_assert(is_hashmap<Map>::value || is_staticmap<Map>::value,
+                  "Data must be a HashMap or a StaticMap");
+
+    JsonStream<Map> body(data);
+    return createFromStream(gateway, body, body.size());
+  }
+
+  /**
+   * @brief Reads data from the Supabase database.
+   * The columns are given as an array of column IDs, usually a
+   * `static constexpr` array kept in flash.
+   *
+   * @param gateway The API endpoint for the specific gateway.
+   * @param cardUID The unique identifier of the card to read data for.
+   * @param columns The columns to read from the response data.
+   * @return A ColumnMap containing the retrieved data, keyed by column.
+   */
+  template <size_t N>
+  ColumnMap readData(String gateway, String cardUID,
+                     const Column (&columns)[N]) {
+    return readColumns(gateway, cardUID, columns, N);
+  }
+
+  /**
+   * @brief Updates existing data in the Supabase database.
+   * Accepts the column data as a HashMap, or as a StaticMap kept in flash.
+   * The columns are streamed as the JSON request body, like in
+   * @ref createData.
+   *
+   * @param gateway The API endpoint for the specific gateway.
+   * @param cardUID The unique identifier of the card to be updated.
+   * @param columnData The data to be updated, organized by column names.
+   * @return True if the data was updated successfully, false otherwise.
+   */
+  template <typename Columns>
+  bool updateData(String gateway, String cardUID, const Columns &columnData) {
+    static_assert(is_hashmap<Columns>::value || is_staticmap<Columns>::value,
+                  "Column data must be a HashMap or a StaticMap");
+
+    JsonStream<Columns> body(columnData);
+    return updateFromStream(gateway, cardUID, body, body.size());
+  }
 
-  bool createData(String gateway, JsonDocument jsonData);
-  HashMap<String, String> readData(String gateway, String cardUID,
-                                   HashMap<String, String> columnData);
-  bool updateData(String gateway, String cardUID,
-                  HashMap<String, String> columnData);
   bool deleteData(String gateway, String key);
 
   bool isDataExists(String gateway);
   String *getMemberByUID(String gateway, String cardUID);
   String *getMemberByName(String gateway, String name);
+  bool getMembers(String gateway, ArrayList<MemberRecord> &members);
   String *getEventByName(String gateway, String eventName);
 };
 
@@ -0,0 +1,426 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <mutex>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Allocator that takes memory straight from the heap.
+ * This is the default allocator of the collections. Every allocator used by
+ * the collections provides the same three methods, and is copied into each
+ * collection that uses it, so allocators with state hold a pointer to it.
+ */
+struct HeapAllocator {
+  /**
+   * @brief Allocates a block of memory.
+   *
+   * @param size The size of the block in bytes.
+   * @throws std::bad_alloc If the block can't be allocated.
+   * @return A pointer to the block.
+   */
+  void *allocate(size_t size) {
+    void *ptr = malloc(size);
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  /**
+   * @brief Frees a block of memory.
+   *
+   * @param ptr The block to free.
+   * @param size The size the block was allocated with.
+   */
+  void deallocate(void *ptr, size_t size) { free(ptr); }
+
+  /**
+   * @brief Resizes a block of memory, keeping its bytes.
+   * Only used for trivially copyable items, which can be moved bytewise.
+   *
+   * @param ptr The block to resize, or nullptr.
+   * @param oldSize The current size of the block.
+   * @param newSize The new size of the block.
+   * @throws std::bad_alloc If the block can't be resized.
+   * @return A pointer to the resized block.
+   */
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    void *newPtr = realloc(ptr, newSize);
+    if (newPtr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return newPtr;
+  }
+};
+
+/**
+ * @brief Allocator with room for one block inside the allocator itself.
+ * The first block that fits is placed in the inline storage, so a
+ * collection holding the allocator doesn't touch the heap while it stays
+ * small. Larger blocks, and blocks requested while the storage is in use,
+ * come from the fallback allocator. Copying the allocator only copies the
+ * fallback, the copy starts with its own empty storage, so a collection
+ * moved out of the storage has to move its items rather than its buffer.
+ *
+ * @tparam Size The size of the inline storage in bytes.
+ * @tparam A The allocator of the blocks that don't fit inline.
+ */
+template <size_t Size, typename A = HeapAllocator> class InlineAllocator {
+  private:
+  alignas(max_align_t) unsigned char storage[Size];
+  bool isUsed;
+  A fallback;
+
+  public:
+  using is_inline_allocator = void;
+
+  /**
+   * @brief Constructor for the InlineAllocator.
+   *
+   * @param fallback The allocator of the blocks that don't fit inline.
+   */
+  InlineAllocator(const A &fallback = A())
+      : isUsed(false), fallback(fallback) {}
+
+  InlineAllocator(const InlineAllocator &other)
+      : isUsed(false), fallback(other.fallback) {}
+
+  /**
+   * @brief Takes over the fallback allocator of another allocator.
+   * The inline storage isn't touched, it may still hold the block of the
+   * collection this allocator belongs to.
+   *
+   * @param other The allocator to copy the fallback from.
+   * @return A reference to this allocator.
+   */
+  InlineAllocator &operator=(const InlineAllocator &other) {
+    fallback = other.fallback;
+    return *this;
+  }
+
+  /**
+   * @brief Allocates a block, inline if it fits and the storage is free.
+   *
+   * @param size The size of the block in bytes.
+   * @throws std::bad_alloc If the fallback allocation fails.
+   * @return A pointer to the block.
+   */
+  void *allocate(size_t size) {
+    if (!isUsed && size <= Size) {
+      isUsed = true;
+      return storage;
+    }
+    return fallback.allocate(size);
+  }
+
+  /**
+   * @brief Frees a block, or marks the inline storage free again.
+   *
+   * @param ptr The block to free.
+   * @param size The size the block was allocated with.
+   */
+  void deallocate(void *ptr, size_t size) {
+    if (owns(ptr)) {
+      isUsed = false;
+      return;
+    }
+    fallback.deallocate(ptr, size);
+  }
+
+  /**
+   * @brief Resizes a block, keeping its bytes.
+   * An inline block that still fits stays in place, and a heap block whose
+   * new size fits moves into the inline storage if it's free.
+   *
+   * @param ptr The block to resize, or nullptr.
+   * @param oldSize The current size of the block.
+   * @param newSize The new size of the block.
+   * @throws std::bad_alloc If the fallback allocation fails.
+   * @return A pointer to the resized block.
+   */
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    if (ptr == nullptr) {
+      return allocate(newSize);
+    }
+    if (owns(ptr)) {
+      if (newSize <= Size) {
+        return ptr;
+      }
+      void *newPtr = fallback.allocate(newSize);
+      memcpy(newPtr, ptr, oldSize);
+      isUsed = false;
+      return newPtr;
+    }
+    if (!isUsed && newSize <= Size) {
+      memcpy(storage, ptr, oldSize < newSize ? oldSize : newSize);
+      fallback.deallocate(ptr, oldSize);
+      isUsed = true;
+      return storage;
+    }
+    return fallback.reallocate(ptr, oldSize, newSize);
+  }
+
+  /**
+   * @brief Checks if a pointer is the inline storage.
+   *
+   * @param ptr The pointer to check.
+   * @return True if the pointer is the inline storage, false otherwise.
+   */
+  bool owns(const void *ptr) const { return ptr == storage; }
+
+  /**
+   * @brief Checks if a block of the given size fits the inline storage.
+   *
+   * @param size The size of the block in bytes.
+   * @return True if the block fits, false otherwise.
+   */
+  bool fits(size_t size) const { return size <= Size; }
+};
+
+/**
+ * @brief A pool of equally sized memory blocks.
+ * The blocks are part of the pool object itself, so a pool declared as a
+ * global lives outside the heap and never fragments it. Blocks are handed out
+ * and returned through a free list in constant time. Requests larger than a
+ * block, or made while the pool is empty, fall back to the heap.
+ *
+ * @tparam BlockSize The size of each block in bytes.
+ * @tparam BlockCount The number of blocks in the pool.
+ */
+template <size_t BlockSize, size_t BlockCount> class FixedBlockPool {
+  private:
+  union Block {
+    Block *next;
+    alignas(max_align_t) unsigned char data[BlockSize];
+  };
+
+  Block blocks[BlockCount];
+  Block *freeList;
+  size_t used;
+  size_t fallbacks;
+  // Allocations may come from several tasks
+  std::mutex lock;
+
+  public:
+  /**
+   * @brief Constructor for the FixedBlockPool.
+   * Links every block into the free list.
+   */
+  FixedBlockPool() : freeList(nullptr), used(0), fallbacks(0) {
+    for (size_t i = BlockCount; i > 0; i--) {
+      blocks[i - 1].next = freeList;
+      freeList = &blocks[i - 1];
+    }
+  }
+
+  FixedBlockPool(const FixedBlockPool &) = delete;
+  FixedBlockPool &operator=(const FixedBlockPool &) = delete;
+
+  /**
+   * @brief Gets the pool shared by every allocator of this block geometry.
+   *
+   * @return The shared pool.
+   */
+  static FixedBlockPool &shared() {
+    static FixedBlockPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Allocates a block, or heap memory if no block fits.
+   *
+   * @param size The size of the block in bytes.
+   * @throws std::bad_alloc If the heap fallback fails.
+   * @return A pointer to the block.
+   */
+  void *allocate(size_t size) {
+    if (size <= BlockSize) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (freeList != nullptr) {
+        Block *block = freeList;
+        freeList = block->next;
+        used++;
+        return block->data;
+      }
+      fallbacks++;
+    }
+    return HeapAllocator().allocate(size);
+  }
+
+  /**
+   * @brief Returns a block to the pool, or frees it if it came from the heap.
+   *
+   * @param ptr The block to free.
+   * @param size The size the block was allocated with.
+   */
+  void deallocate(void *ptr, size_t size) {
+    if (!owns(ptr)) {
+      free(ptr);
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    Block *block = reinterpret_cast<Block *>(ptr);
+    block->next = freeList;
+    freeList = block;
+    used--;
+  }
+
+  /**
+   * @brief Resizes a block, keeping its bytes.
+   * A block that still fits is kept as it is.
+   *
+   * @param ptr The block to resize, or nullptr.
+   * @param oldSize The current size of the block.
+   * @param newSize The new size of the block.
+   * @return A pointer to the resized block.
+   */
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    if (ptr != nullptr && owns(ptr) && newSize <= BlockSize) {
+      return ptr;
+    }
+    void *newPtr = allocate(newSize);
+    if (ptr != nullptr) {
+      memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+      deallocate(ptr, oldSize);
+    }
+    return newPtr;
+  }
+
+  /**
+   * @brief Checks if a pointer is one of the pool's blocks.
+   *
+   * @param ptr The pointer to check.
+   * @return True if the pointer belongs to the pool, false otherwise.
+   */
+  bool owns(const void *ptr) const {
+    uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+    return address >= reinterpret_cast<uintptr_t>(&blocks[0]) &&
+           address < reinterpret_cast<uintptr_t>(&blocks[BlockCount]);
+  }
+
+  /**
+   * @brief Gets the number of blocks in use.
+   *
+   * @return The number of blocks handed out.
+   */
+  size_t getUsed() const { return used; }
+
+  /**
+   * @brief Gets the number of allocations that fell back to the heap because
+   * the pool was empty.
+   *
+   * @return The number of heap fallbacks.
+   */
+  size_t getFallbacks() const { return fallbacks; }
+};
+
+/**
+ * @brief Allocator that takes memory from a FixedBlockPool.
+ * A default-constructed allocator uses the pool shared by every allocator of
+ * the same pool type.
+ *
+ * @tparam Pool The FixedBlockPool type.
+ */
+template <typename Pool> class PoolAllocator {
+  private:
+  Pool *pool;
+
+  public:
+  /**
+   * @brief Constructor for the PoolAllocator.
+   *
+   * @param pool The pool to allocate from.
+   */
+  PoolAllocator(Pool &pool = Pool::shared()) : pool(&pool) {}
+
+  void *allocate(size_t size) { return pool->allocate(size); }
+  void deallocate(void *ptr, size_t size) { pool->deallocate(ptr, size); }
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    return pool->reallocate(ptr, oldSize, newSize);
+  }
+};
+
+/**
+ * @brief A bump allocator for memory used by a single operation.
+ * Allocating only advances an offset into a preallocated buffer, and freeing
+ * single blocks does nothing. Everything is given back at once by
+ * @ref release, typically at the end of the operation. If the buffer runs
+ * out, further blocks are taken from the heap and freed by release as well.
+ */
+class Arena {
+  private:
+  /**
+   * @brief A heap block allocated after the buffer ran out.
+   */
+  struct alignas(max_align_t) Overflow {
+    Overflow *next;
+  };
+
+  unsigned char *buffer;
+  size_t capacity;
+  size_t offset;
+  size_t peak;
+  Overflow *overflow;
+
+  public:
+  Arena(size_t capacity);
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *allocate(size_t size);
+  void deallocate(void *ptr, size_t size);
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize);
+  void release();
+
+  size_t getUsed() const;
+  size_t getPeak() const;
+};
+
+/**
+ * @brief Allocator that takes memory from an Arena.
+ * Collections using it must be destroyed before the arena is released.
+ */
+class ArenaAllocator {
+  private:
+  Arena *arena;
+
+  public:
+  /**
+   * @brief Constructor for the ArenaAllocator.
+   *
+   * @param arena The arena to allocate from.
+   */
+  ArenaAllocator(Arena &arena) : arena(&arena) {}
+
+  void *allocate(size_t size) { return arena->allocate(size); }
+  void deallocate(void *ptr, size_t size) { arena->deallocate(ptr, size); }
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    return arena->reallocate(ptr, oldSize, newSize);
+  }
+};
+
+/**
+ * @brief Releases an arena when it goes out of scope.
+ * Declare the scope before the collections that use the arena, so they are
+ * destroyed first.
+ */
+class ArenaScope {
+  private:
+  Arena &arena;
+
+  public:
+  ArenaScope(Arena &arena) : arena(arena) {}
+  ~ArenaScope() { arena.release(); }
+
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+};
+
+#endif
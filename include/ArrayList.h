@@ -3,33 +3,171 @@
 
 // #define ENABLE_COLLECTION_HELPERS
 
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+// Import allocators for the item buffer
+#include <Allocator.h>
+
+// Import JSON writer for streaming the list to a Print
+#include <JsonWriter.h>
+
+// Import collection stats for the allocation counters
+#include <CollectionStats.h>
+
+// Import type traits for checking if the allocator keeps its block inline
+#include <TypeTraits.h>
+
 /**
  * @brief A dynamic array class for storing items.
  * This class provides a simple implementation of a dynamic array
  * that can grow in size as needed.
+ * The items live in uninitialised raw storage, so only the stored items are
+ * ever constructed. Growing moves the items into the new buffer, and lists of
+ * trivially copyable items are resized in place when the allocator can.
+ *
+ * @tparam T The type of the items.
+ * @tparam A The allocator of the item buffer, see Allocator.h.
  *
  * @note This class is custom data collections class that inspired by Java's
  * ArrayList.
  */
-template <typename T> class ArrayList {
+template <typename T, typename A = HeapAllocator> class ArrayList {
   private:
   T *items;
   size_t capacity;
   size_t count;
+  A allocator;
+#ifdef ENABLE_COLLECTION_STATS
+  CollectionStats stats{"ArrayList"};
+#endif
+
+  /**
+   * @brief Moves the items into a buffer of the given capacity.
+   * Trivially copyable items are moved with the allocator's reallocate,
+   * which can often extend the buffer in place. Other items are
+   * move-constructed into a new buffer and destroyed in the old one.
+   *
+   * @param newCapacity The capacity of the new buffer, at least the size.
+   * @throws std::bad_alloc If the buffer can't be allocated.
+   */
+  void reallocate(size_t newCapacity) {
+    if (newCapacity == 0) {
+      freeItems();
+      return;
+    }
+    if constexpr (is_inline_allocator<A>::value) {
+      // The inline storage has a fixed size, items that still fit it stay
+      if (items != nullptr && allocator.owns(items) &&
+          allocator.fits(newCapacity * sizeof(T))) {
+        capacity = newCapacity;
+        return;
+      }
+    }
+
+    T *newItems;
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      newItems = static_cast<T *>(allocator.reallocate(
+          items, capacity * sizeof(T), newCapacity * sizeof(T)));
+    } else {
+      newItems = static_cast<T *>(allocator.allocate(newCapacity * sizeof(T)));
+      for (size_t i = 0; i < count; i++) {
+        new (&newItems[i]) T(std::move(items[i]));
+        items[i].~T();
+      }
+      freeItems();
+    }
+    items = newItems;
+    capacity = newCapacity;
+#ifdef ENABLE_COLLECTION_STATS
+    stats.recordAllocation(newCapacity * sizeof(T));
+    stats.recordResize(newCapacity);
+#endif
+  }
+
+  /**
+   * @brief Gives the item buffer back to the allocator.
+   * The items must have been destroyed or moved out before.
+   */
+  void freeItems() {
+    if (items != nullptr) {
+      allocator.deallocate(items, capacity * sizeof(T));
+    }
+    items = nullptr;
+    capacity = 0;
+  }
 
   /**
    * @brief Resizes the internal array to accommodate more items.
    * This method doubles the capacity of the internal array
-   * and copies existing items to the new array.
+   * and moves existing items to the new array.
    */
-  void resize() {
-    capacity *= 2;
-    T *newItems = new T[capacity];
-    for (size_t i = 0; i < count; i++) {
-      newItems[i] = items[i];
+  void resize() { reallocate(capacity > 0 ? capacity * 2 : 4); }
+
+  /**
+   * @brief Copies the items of another list into this empty list.
+   *
+   * @param other The array list to copy from.
+   */
+  void copyFrom(const ArrayList &other) {
+    if (capacity < other.count) {
+      reallocate(other.count);
     }
-    delete[] items;
-    items = newItems;
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      if (other.count > 0) {
+        memcpy(static_cast<void *>(items), other.items,
+               other.count * sizeof(T));
+      }
+    } else {
+      for (size_t i = 0; i < other.count; i++) {
+        new (&items[i]) T(other.items[i]);
+      }
+    }
+    count = other.count;
+  }
+
+  /**
+   * @brief Takes over the items of another list into this empty list.
+   * The buffer of the other list is taken as it is, unless it's the inline
+   * storage of the other list's allocator. Those items are moved one by one
+   * and the other list keeps its storage.
+   *
+   * @param other The array list to take the items from.
+   */
+  void takeFrom(ArrayList &other) {
+    if constexpr (is_inline_allocator<A>::value) {
+      if (other.items != nullptr && other.allocator.owns(other.items)) {
+        reserve(other.capacity);
+        for (size_t i = 0; i < other.count; i++) {
+          new (&items[i]) T(std::move(other.items[i]));
+        }
+        count = other.count;
+        other.destroyItems();
+        return;
+      }
+    }
+    items = other.items;
+    capacity = other.capacity;
+    count = other.count;
+    other.items = nullptr;
+    other.capacity = 0;
+    other.count = 0;
+  }
+
+  /**
+   * @brief Destroys every item, keeping the buffer.
+   */
+  void destroyItems() {
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+      for (size_t i = 0; i < count; i++) {
+        items[i].~T();
+      }
+    }
+    count = 0;
   }
 
   public:
@@ -39,52 +177,89 @@ template <typename T> class ArrayList {
   /**
    * @brief Default constructor for the ArrayList.
    * Initializes an empty array list with a default initial capacity.
+   * No item is constructed until it's added.
    *
    * @param initialCapacity The initial capacity of the array list.
+   * @param allocator The allocator of the item buffer.
    */
-  ArrayList(size_t initialCapacity = 4) : capacity(initialCapacity), count(0) {
-    items = new T[capacity];
+  ArrayList(size_t initialCapacity = 4, const A &allocator = A())
+      : items(nullptr), capacity(0), count(0), allocator(allocator) {
+    reserve(initialCapacity);
   }
 
   /**
    * @brief Copy constructor for the ArrayList.
    * Creates a new array list by copying items from another array list.
+   * The new list is allocated with just enough room for the items.
    *
    * @param other The array list to copy from.
    */
-  ArrayList(const ArrayList<T> &other)
-      : capacity(other.capacity), count(other.count) {
-    items = new T[capacity];
-    for (size_t i = 0; i < count; i++) {
-      items[i] = other.items[i];
-    }
+  ArrayList(const ArrayList &other)
+      : items(nullptr), capacity(0), count(0), allocator(other.allocator) {
+#ifdef ENABLE_COLLECTION_STATS
+    stats.setLabel(other.stats.getLabel());
+#endif
+    copyFrom(other);
   }
 
   /**
    * @brief Assignment operator for the ArrayList.
    * Assigns the contents of another array list to this array list.
+   * The current buffer is reused if it's large enough.
    *
    * @param other The array list to assign from.
    * @return A reference to this array list.
    */
-  ArrayList &operator=(const ArrayList<T> &other) {
+  ArrayList &operator=(const ArrayList &other) {
     if (this != &other) {
-      delete[] items;
-      capacity = other.capacity;
-      count = other.count;
-      items = new T[capacity];
-      for (size_t i = 0; i < count; i++) {
-        items[i] = other.items[i];
-      }
+      destroyItems();
+      copyFrom(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move constructor for the ArrayList.
+   * Takes over the items of another array list without copying them.
+   * The other array list is left empty.
+   *
+   * @param other The array list to move from.
+   */
+  ArrayList(ArrayList &&other)
+      : items(nullptr), capacity(0), count(0), allocator(other.allocator) {
+#ifdef ENABLE_COLLECTION_STATS
+    stats.setLabel(other.stats.getLabel());
+#endif
+    takeFrom(other);
+  }
+
+  /**
+   * @brief Move assignment operator for the ArrayList.
+   * Takes over the items of another array list without copying them,
+   * together with the allocator of their buffer.
+   * The other array list is left empty.
+   *
+   * @param other The array list to move from.
+   * @return A reference to this array list.
+   */
+  ArrayList &operator=(ArrayList &&other) {
+    if (this != &other) {
+      destroyItems();
+      freeItems();
+      allocator = other.allocator;
+      takeFrom(other);
     }
     return *this;
   }
 
   /**
    * @brief Destructor for the ArrayList.
-   * Cleans up the internal array to prevent memory leaks.
+   * Destroys the items and frees the internal array to prevent memory leaks.
    */
-  ~ArrayList() { delete[] items; }
+  ~ArrayList() {
+    destroyItems();
+    freeItems();
+  }
 
   /**
    * @brief Adds an item to the end of the list.
@@ -93,11 +268,88 @@ template <typename T> class ArrayList {
    *
    * @param item The item to add to the list.
    */
-  void add(T item) {
+  void add(const T &item) { emplace(item); }
+
+  /**
+   * @brief Adds an item to the end of the list by moving it.
+   * This method appends the specified item to the end of the list
+   * without copying it, increasing the size of the list if necessary.
+   *
+   * @param item The item to move into the list.
+   */
+  void add(T &&item) { emplace(std::move(item)); }
+
+  /**
+   * @brief Constructs an item at the end of the list.
+   * This method builds the item in place from the given constructor
+   * arguments, increasing the size of the list if necessary.
+   *
+   * @param args The arguments passed to the item's constructor.
+   * @return A reference to the new item.
+   */
+  template <typename... Args> T &emplace(Args &&...args) {
     if (count == capacity) {
+      // The arguments may refer to an item of this list, so the new item is
+      // built before the buffer moves
+      T item(std::forward<Args>(args)...);
       resize();
+      new (&items[count]) T(std::move(item));
+    } else {
+      new (&items[count]) T(std::forward<Args>(args)...);
+    }
+    return items[count++];
+  }
+
+  /**
+   * @brief Inserts an item at the specified index.
+   * This method shifts the item currently at that index and any subsequent
+   * items up by one, increasing the size of the list if necessary.
+   *
+   * @param index The index at which the item is inserted.
+   * @param item The item to insert into the list.
+   * @throws std::out_of_range If the index is greater than the list size.
+   */
+  void add(size_t index, T item) {
+    if (index > count) {
+      throw std::out_of_range("Index out of range");
+    }
+    if (index == count) {
+      emplace(std::move(item));
+      return;
+    }
+    if (count == capacity) {
+      resize();
+    }
+    new (&items[count]) T(std::move(items[count - 1]));
+    for (size_t i = count - 1; i > index; i--) {
+      items[i] = std::move(items[i - 1]);
+    }
+    items[index] = std::move(item);
+    count++;
+  }
+
+  /**
+   * @brief Makes room for at least the given number of items.
+   * Reserving the expected size up front means the list doesn't have to grow
+   * while it's being filled. A smaller capacity than the current one is
+   * ignored.
+   *
+   * @param minCapacity The number of items the list should hold.
+   */
+  void reserve(size_t minCapacity) {
+    if (minCapacity > capacity) {
+      reallocate(minCapacity);
+    }
+  }
+
+  /**
+   * @brief Releases the unused capacity of the list.
+   * Useful for long-lived lists once they have been filled.
+   */
+  void shrinkToFit() {
+    if (capacity > count) {
+      reallocate(count);
     }
-    items[count++] = item;
   }
 
   /**
@@ -106,9 +358,25 @@ template <typename T> class ArrayList {
    *
    * @param index The index of the item to retrieve.
    * @throws std::out_of_range If the index is out of range.
-   * @return The item at the specified index.
+   * @return A reference to the item at the specified index.
+   */
+  const T &get(size_t index) const {
+    if (index < count) {
+      return items[index];
+    }
+    throw std::out_of_range("Index out of range");
+  }
+
+  /**
+   * @brief Gets the item at the specified index for modification.
+   * This method returns a reference to the item at the specified index,
+   * so the item can be changed in place.
+   *
+   * @param index The index of the item to retrieve.
+   * @throws std::out_of_range If the index is out of range.
+   * @return A reference to the item at the specified index.
    */
-  T get(size_t index) const {
+  T &get(size_t index) {
     if (index < count) {
       return items[index];
     }
@@ -118,19 +386,25 @@ template <typename T> class ArrayList {
   /**
    * @brief Removes the item at the specified index.
    * This method removes the item at the specified index from the list,
-   * shifting subsequent items down to fill the gap.
+   * shifting subsequent items down to fill the gap. Trivially copyable items
+   * are shifted with a single memmove.
    *
    * @param index The index of the item to remove.
    * @throws std::out_of_range If the index is out of range.
    */
   void remove(size_t index) {
-    if (index < count) {
-      for (size_t i = index; i < count - 1; i++) {
-        items[i] = items[i + 1];
-      }
+    if (index >= count) {
+      throw std::out_of_range("Index out of range");
+    }
+    if constexpr (std::is_trivially_copyable<T>::value) {
+      memmove(static_cast<void *>(items + index), items + index + 1,
+              (count - index - 1) * sizeof(T));
       count--;
     } else {
-      throw std::out_of_range("Index out of range");
+      for (size_t i = index; i < count - 1; i++) {
+        items[i] = std::move(items[i + 1]);
+      }
+      items[--count].~T();
     }
   }
 
@@ -138,18 +412,84 @@ template <typename T> class ArrayList {
    * @brief Removes the first occurrence of the specified item.
    * This method searches for the specified item in the list and removes
    * the first occurrence found, shifting subsequent items down to fill the gap.
+   * Nothing is removed if the item isn't in the list.
    *
    * @param item The item to remove from the list.
+   * @return True if the item was removed, false if it wasn't found.
+   */
+  bool remove(const T &item) {
+    std::optional<size_t> index = find(item);
+    if (!index) {
+      return false;
+    }
+    remove(*index);
+    return true;
+  }
+
+  /**
+   * @brief Removes the item at the specified index without keeping order.
+   * The last item is moved into the gap instead of shifting every later
+   * item, so the removal takes constant time.
+   *
+   * @param index The index of the item to remove.
+   * @throws std::out_of_range If the index is out of range.
    */
-  void remove(const T &item) {
-    size_t index = 0;
+  void swapRemove(size_t index) {
+    if (index >= count) {
+      throw std::out_of_range("Index out of range");
+    }
+    if (index != count - 1) {
+      items[index] = std::move(items[count - 1]);
+    }
+    items[--count].~T();
+  }
+
+  /**
+   * @brief Removes every item that matches the predicate.
+   * The kept items are compacted towards the front in a single pass, so
+   * removing many items from a large list takes linear time. The kept items
+   * stay in their order.
+   *
+   * @code
+   * pending.removeIf([](const Record &record) { return record.acked; });
+   * @endcode
+   *
+   * @param predicate The function that returns true for the items to remove.
+   * @return The number of items removed.
+   */
+  template <typename Predicate> size_t removeIf(Predicate predicate) {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (predicate(static_cast<const T &>(items[i]))) {
+        continue;
+      }
+      if (kept != i) {
+        items[kept] = std::move(items[i]);
+      }
+      kept++;
+    }
+
+    size_t removed = count - kept;
+    for (size_t i = kept; i < count; i++) {
+      items[i].~T();
+    }
+    count = kept;
+    return removed;
+  }
+
+  /**
+   * @brief Finds the first occurrence of the specified item.
+   *
+   * @param item The item to search for.
+   * @return The index of the item, or no value if it isn't in the list.
+   */
+  std::optional<size_t> find(const T &item) const {
     for (size_t i = 0; i < count; i++) {
       if (items[i] == item) {
-        index = i;
-        break;
+        return i;
       }
     }
-    remove(index);
+    return std::nullopt;
   }
 
   /**
@@ -167,26 +507,14 @@ template <typename T> class ArrayList {
    * @param item The item to check for in the list.
    * @return True if the item is found, false otherwise.
    */
-  bool contains(const T &item) const {
-    size_t index = 0;
-    for (size_t i = 0; i < count; i++) {
-      if (items[i] == item) {
-        index = i;
-        return true;
-      }
-    }
-    return false;
-  }
+  bool contains(const T &item) const { return find(item).has_value(); }
 
   /**
    * @brief Clears all items from the list.
    * This method removes all items from the list and resets its size.
+   * The buffer is kept, so refilling the list doesn't allocate again.
    */
-  void clear() {
-    delete[] items;
-    items = new T[capacity];
-    count = 0;
-  }
+  void clear() { destroyItems(); }
 
   /**
    * @brief Gets the number of items in the list.
@@ -196,6 +524,39 @@ template <typename T> class ArrayList {
    */
   size_t size() const { return count; }
 
+  /**
+   * @brief Gets the number of items the list can hold without growing.
+   *
+   * @return The capacity of the list.
+   */
+  size_t getCapacity() const { return capacity; }
+
+#ifdef ENABLE_COLLECTION_STATS
+  /**
+   * @brief Names this list in the collection stats report.
+   *
+   * @param label The name of the list, must outlive it.
+   */
+  void setStatsLabel(const char *label) { stats.setLabel(label); }
+#endif
+
+  /**
+   * @brief Writes the list as a JSON array to a Print.
+   * The text is written straight to the sink, such as Serial or an HTTP
+   * body, without building a JsonDocument or a String.
+   *
+   * @param out The sink to write to.
+   * @return The number of bytes written.
+   */
+  size_t printJsonTo(Print &out) const { return printJsonValue(out, *this); }
+
+  /**
+   * @brief Measures the length of the JSON text of the list.
+   *
+   * @return The number of bytes @ref printJsonTo writes.
+   */
+  size_t measureJsonLength() const { return measureJsonValue(*this); }
+
 #ifdef ENABLE_COLLECTION_HELPERS
   /**
    * @brief Converts the list to a string representation.
@@ -0,0 +1,57 @@
+#ifndef ATTENDANCELEDGER_H
+#define ATTENDANCELEDGER_H
+
+#include <Arduino.h>
+
+// Import package for Preferences Database (Local)
+#include <Preferences.h>
+
+// Size of a ledger entry: the UID length followed by up to 10 UID bytes
+#define LEDGER_ENTRY_SIZE 11
+
+/**
+ * @brief AttendanceLedger class for recording check-ins on the device.
+ * This class keeps the card UIDs of the members that have already checked
+ * in for the current event, so duplicate taps are answered without any
+ * server call, even after a restart. Entries are keyed on the UID itself,
+ * so they stay valid when the roster is reloaded or reordered, and the
+ * ledger is only cleared when the event changes.
+ * Check-ins are persisted to the Preferences database in batches by
+ * @ref flush, a check-in lost to a power cut is answered by the server.
+ */
+class AttendanceLedger {
+  private:
+  // Preferences database the ledger is persisted to
+  Preferences *pref;
+  // Event name the ledger belongs to
+  String event;
+  // Packed UIDs of the members that checked in
+  uint8_t *entries;
+  // Number of entries in the ledger
+  size_t length;
+  // Number of entries the buffer has room for
+  size_t capacity;
+  // Whether check-ins were recorded since the last flush
+  bool isDirty;
+
+  static bool pack(const String &uid, uint8_t *entry);
+  bool containsEntry(const uint8_t *entry) const;
+  void persist();
+
+  public:
+  AttendanceLedger();
+  ~AttendanceLedger();
+
+  AttendanceLedger(const AttendanceLedger &) = delete;
+  AttendanceLedger &operator=(const AttendanceLedger &) = delete;
+
+  void begin(Preferences &pref);
+  void sync(const String &event);
+  void flush();
+
+  bool contains(const String &uid) const;
+  void mark(const String &uid);
+  size_t count() const;
+};
+
+#endif
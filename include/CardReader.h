@@ -0,0 +1,237 @@
+#ifndef CARDREADER_H
+#define CARDREADER_H
+
+#include <Arduino.h>
+
+// Import package for Data Collections
+#include <ArrayList.h>
+
+// Import package for FreeRTOS mutex guards
+#include <SemaphoreGuard.h>
+
+// Maximum length of a card UID in bytes
+#define CARD_UID_MAX_SIZE 10
+// Size of a MIFARE Classic data block in bytes
+#define CARD_BLOCK_SIZE 16
+
+/**
+ * @brief The UID of an RFID card, as read during anticollision.
+ */
+struct CardUID {
+  uint8_t bytes[CARD_UID_MAX_SIZE] = {};
+  uint8_t size = 0;
+
+  bool operator==(const CardUID &other) const;
+  bool operator!=(const CardUID &other) const { return !(*this == other); }
+  String toString() const;
+};
+
+/**
+ * @brief A card read by the reader task, waiting to be processed.
+ */
+struct TapEvent {
+  CardUID uid;
+  // Record block read from the card before it was halted
+  uint8_t record[CARD_BLOCK_SIZE] = {};
+  bool hasRecord = false;
+  // Time of the read, in milliseconds since boot
+  uint32_t tappedAt = 0;
+};
+
+// Number of recently read cards remembered by the debouncer
+#define TAP_DEBOUNCE_SLOTS 8
+
+/**
+ * @brief Suppresses repeated reads of the same card.
+ * A card that's tapped again within the window of its last accepted tap is
+ * rejected, so a member who taps twice, or whose card bounces in and out of
+ * the field, is only processed once. The last TAP_DEBOUNCE_SLOTS cards are
+ * remembered, so cards tapped in turn are told apart.
+ */
+class TapDebouncer {
+  private:
+  CardUID cards[TAP_DEBOUNCE_SLOTS];
+  uint32_t acceptedAt[TAP_DEBOUNCE_SLOTS] = {};
+  size_t next = 0;
+  uint32_t window;
+
+  public:
+  TapDebouncer(uint32_t windowMs);
+
+  bool accept(const CardUID &uid, uint32_t now);
+  void setWindow(uint32_t windowMs);
+};
+
+/**
+ * @brief A source of card reads, such as an RFID reader.
+ * The attendance task waits on the source instead of polling the reader, so
+ * a tap is handled as soon as the card enters the field. Implementations
+ * decide how the wait works: the MFRC522 source sleeps until its IRQ pin
+ * fires, the simulated source until a test taps a card.
+ */
+class CardSource {
+  protected:
+  // Data block read from every card before it's halted, or -1 for none
+  int recordBlock = -1;
+
+  public:
+  virtual ~CardSource() = default;
+
+  /**
+   * @brief Sets the data block that @ref readCards reads from every card.
+   * Reading the block costs an authentication and a read per card, so it's
+   * off by default.
+   *
+   * @param block The block number, or -1 to only read UIDs.
+   */
+  void setRecordBlock(int block) { recordBlock = block; }
+
+  /**
+   * @brief Prepares the source, called once after the hardware is set up.
+   */
+  virtual void begin() = 0;
+
+  /**
+   * @brief Waits until a card may have entered the field.
+   * A true result is a hint, the card still has to be read with
+   * @ref readCard.
+   *
+   * @param timeoutMs The longest time to wait in milliseconds.
+   * @return True if a card was detected, false if the wait timed out.
+   */
+  virtual bool waitForCard(uint32_t timeoutMs) = 0;
+
+  /**
+   * @brief Selects a card in the field, reads its UID and halts it.
+   * A halted card isn't read again until it leaves the field.
+   *
+   * @param uid Receives the UID of the card.
+   * @return True if a card was read, false otherwise.
+   */
+  virtual bool readCard(CardUID &uid) = 0;
+
+  /**
+   * @brief Reads every card in the field in one pass.
+   * Cards are selected one at a time by anticollision and halted after
+   * their UID is read, so a halted card stays silent and the next request
+   * is answered by the remaining cards only. The pass ends when no card
+   * answers anymore or the array is full. Sources that can't read data
+   * blocks only fill in the UIDs.
+   *
+   * @param cards Receives the UIDs and record blocks of the cards.
+   * @param max The number of cards the array can hold.
+   * @return The number of cards read.
+   */
+  virtual size_t readCards(TapEvent *cards, size_t max) {
+    size_t count = 0;
+    while (count < max && readCard(cards[count].uid)) {
+      cards[count].hasRecord = false;
+      count++;
+    }
+    return count;
+  }
+};
+
+/**
+ * @brief A card source driven by software instead of a reader.
+ * It simulates the cards in the field of a reader. A card put into the
+ * field with @ref enter answers requests until it's read, which halts it
+ * like PICC_HaltA does. A halted card stays silent until it leaves the
+ * field with @ref leave. Several cards can be in the field at once, and
+ * anticollision selects them in the order they entered. It has no hardware
+ * dependency, so the attendance flow can be exercised on a host.
+ */
+class SimulatedCardSource : public CardSource {
+  private:
+  /**
+   * @brief A card in the simulated field.
+   */
+  struct FieldCard {
+    CardUID uid;
+    // Read and halted, silent until it leaves the field
+    bool halted;
+    // Taken away from the field as soon as it's read
+    bool leavesAfterRead;
+  };
+
+  // Guards the field, cards are put into it from other tasks
+  StaticSemaphore_t lockBuffer;
+  SemaphoreHandle_t lock;
+  // Given when a card enters the field, to wake a task in waitForCard
+  StaticSemaphore_t enteredBuffer;
+  SemaphoreHandle_t entered;
+  ArrayList<FieldCard> field;
+
+  bool hasIdleCard() const;
+
+  public:
+  SimulatedCardSource();
+  SimulatedCardSource(const SimulatedCardSource &) = delete;
+  SimulatedCardSource &operator=(const SimulatedCardSource &) = delete;
+
+  void begin() override;
+  bool waitForCard(uint32_t timeoutMs) override;
+  bool readCard(CardUID &uid) override;
+
+  void enter(const CardUID &uid);
+  void leave(const CardUID &uid);
+  void tap(const CardUID &uid);
+};
+
+#ifdef ARDUINO
+// Import package for RFID System
+#include <MFRC522.h>
+
+// Interval between two card requests while the field is empty
+#define CARD_REARM_INTERVAL 100
+// Key A of the record sector, the transport key of a blank card
+#define CARD_SECTOR_KEY {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
+// Number of cards remembered for refusing the key of the record sector
+#define CARD_LOCKED_SLOTS 8
+
+/**
+ * @brief A card source backed by an MFRC522 reader and its IRQ pin.
+ * The reader is set up to raise its IRQ pin when it receives a frame. The
+ * source then sends a card request (REQA) and lets the reader wait for the
+ * answer in hardware, so the waiting task sleeps until a card answers and
+ * the pin wakes it through a task notification. A card only answers while
+ * it's in the field, so the request is repeated every CARD_REARM_INTERVAL
+ * milliseconds. Each rearm idles the reader, flushes its FIFO and sends
+ * the request again, which costs six register writes instead of a full
+ * poll.
+ *
+ * A card that refuses the key of the record sector drops back to idle
+ * instead of halting, so it would answer every request while it's held on
+ * the reader. The last CARD_LOCKED_SLOTS such cards are remembered and read
+ * without their record, which lets them be halted like any other card.
+ */
+class MFRC522CardSource : public CardSource {
+  private:
+  MFRC522 &reader;
+  uint8_t irqPin;
+  // Task blocked in waitForCard, notified by the IRQ pin
+  volatile TaskHandle_t waiter;
+  // Cards that refused the key of the record sector
+  CardUID lockedCards[CARD_LOCKED_SLOTS];
+  size_t nextLocked = 0;
+
+  static void IRAM_ATTR onIrq(void *arg);
+  void clearIrq();
+  void requestCard();
+  bool authenticate(uint8_t block);
+  bool isLocked(const CardUID &uid) const;
+  void setLocked(const CardUID &uid, bool isLocked);
+  bool selectCard(TapEvent &card, bool requested);
+
+  public:
+  MFRC522CardSource(MFRC522 &reader, uint8_t irqPin);
+
+  void begin() override;
+  bool waitForCard(uint32_t timeoutMs) override;
+  bool readCard(CardUID &uid) override;
+  size_t readCards(TapEvent *cards, size_t max) override;
+  bool writeBlock(uint8_t block, const uint8_t *data);
+};
+#endif
+
+#endif
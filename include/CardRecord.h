@@ -0,0 +1,87 @@
+#ifndef CARDRECORD_H
+#define CARDRECORD_H
+
+#include <Arduino.h>
+
+// Import package for Preferences Database (Local)
+#include <Preferences.h>
+
+// Import package for Card UID
+#include <CardReader.h>
+
+// Import package for Member Record
+#include <MemberRecord.h>
+
+// Format version of the record, stored in its first byte
+#define CARD_RECORD_VERSION 1
+// Data block of a MIFARE Classic card holding the record (sector 1)
+#define CARD_RECORD_BLOCK 4
+// Most NIM digits a record holds, two digits per byte
+#define CARD_RECORD_NIM_DIGITS 12
+// Length of the truncated HMAC-SHA256 tag in bytes
+#define CARD_RECORD_TAG_SIZE 4
+// Length of the signing key in bytes
+#define CARD_RECORD_KEY_SIZE 32
+
+/**
+ * @brief The member identity stored on a card.
+ * The record is written to a card at registration, so the kiosk can
+ * identify the member from the card alone when it's tapped. It fits a
+ * single 16 byte MIFARE block:
+ *
+ * | Bytes  | Field                                          |
+ * |--------|------------------------------------------------|
+ * | 0      | Record version, CARD_RECORD_VERSION            |
+ * | 1      | Division, an index into the division table     |
+ * | 2..5   | Member ID, big endian                          |
+ * | 6..11  | NIM in BCD, padded with 0xF nibbles            |
+ * | 12..15 | HMAC-SHA256 of the card UID and bytes 0..11    |
+ *
+ * The tag covers the card UID, so a record copied to another card is
+ * rejected.
+ */
+struct CardRecord {
+  // Member ID in the member table
+  uint32_t memberId = 0;
+  // Index of the member division in the division table
+  uint8_t division = 0;
+  // Member NIM, as null-terminated digits
+  char nim[CARD_RECORD_NIM_DIGITS + 1] = {};
+
+  bool assign(const MemberRecord &member);
+  const char *divisionName() const;
+};
+
+/**
+ * @brief CardSigner class for encoding and verifying card records.
+ * The signer holds the secret key of the kiosk. The key is generated from
+ * the hardware random number generator on first boot and kept in the
+ * Preferences database, so only records written by this kiosk verify.
+ */
+class CardSigner {
+  private:
+  // Secret key of the HMAC tag
+  uint8_t key[CARD_RECORD_KEY_SIZE];
+  // Whether a key was loaded or set
+  bool hasKey;
+
+  bool sign(const CardUID &uid, const uint8_t *block, uint8_t *tag) const;
+
+  public:
+  CardSigner();
+  ~CardSigner();
+
+  CardSigner(const CardSigner &) = delete;
+  CardSigner &operator=(const CardSigner &) = delete;
+
+  void begin(Preferences &pref);
+  void setKey(const uint8_t *secret, size_t length);
+  bool isReady() const;
+
+  bool encode(const CardRecord &record, const CardUID &uid,
+              uint8_t *block) const;
+  bool decode(const uint8_t *block, const CardUID &uid,
+              CardRecord &record) const;
+};
+
+#endif
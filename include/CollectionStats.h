@@ -0,0 +1,79 @@
+#ifndef COLLECTIONSTATS_H
+#define COLLECTIONSTATS_H
+
+// Define ENABLE_COLLECTION_STATS in the build flags (-D ENABLE_COLLECTION_STATS)
+// so that every source file sees the same collection layout.
+// Without it, nothing in this file is compiled and the collections carry no
+// counters at all.
+
+#ifdef ENABLE_COLLECTION_STATS
+
+#include <Arduino.h>
+
+/**
+ * @brief Heap traffic counters of a collection.
+ */
+struct CollectionCounters {
+  // Number of blocks taken from the allocator
+  uint32_t allocations = 0;
+  // Total size of those blocks in bytes
+  uint32_t bytes = 0;
+  // Highest capacity, in items or buckets
+  uint32_t peakCapacity = 0;
+  // Number of times the storage was reallocated or rehashed
+  uint32_t resizes = 0;
+  // Number of key lookups
+  uint32_t lookups = 0;
+  // Number of entries compared by those lookups
+  uint32_t probes = 0;
+  // Highest number of entries compared by a single lookup
+  uint32_t maxProbe = 0;
+
+  void merge(const CollectionCounters &other);
+};
+
+/**
+ * @brief Counters of a single collection instance.
+ * Every instance registers itself in a global registry, so all collections
+ * can be reported together by @ref dump. When an instance is destroyed its
+ * counters are added to the totals of its label, so short-lived collections
+ * still show up in the report. Instances are labelled by their type unless
+ * they're given a name with COLLECTION_LABEL.
+ */
+class CollectionStats {
+  private:
+  const char *label;
+  CollectionStats *prev;
+  CollectionStats *next;
+
+  void link();
+  void unlink();
+
+  public:
+  CollectionCounters counters;
+
+  CollectionStats(const char *label);
+  CollectionStats(const CollectionStats &other);
+  CollectionStats &operator=(const CollectionStats &other);
+  ~CollectionStats();
+
+  void setLabel(const char *label);
+  const char *getLabel() const;
+  void recordAllocation(size_t bytes);
+  void recordCapacity(size_t capacity);
+  void recordResize(size_t capacity);
+  void recordLookup(size_t probes);
+
+  static void dump(Print &out);
+};
+
+// Names a collection instance in the collection stats report
+#define COLLECTION_LABEL(collection, name) (collection).setStatsLabel(name)
+
+#else
+
+#define COLLECTION_LABEL(collection, name)
+
+#endif
+
+#endif
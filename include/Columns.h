@@ -0,0 +1,95 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <Arduino.h>
+
+// Import JSON writer for writing a column as an object key
+#include <JsonWriter.h>
+
+// Import package for Flat Map (Local)
+#include <FlatMap.h>
+
+/**
+ * @brief The database columns the device reads and writes.
+ * A column is a small integer, so maps keyed by columns compare keys as
+ * integers and never copy the key text to the heap. The text of a column is
+ * only looked up, in @ref columnName, where a request or a JSON body needs
+ * it. New columns are added before COUNT, with their name in COLUMN_NAMES.
+ */
+enum class Column : uint8_t {
+  UID,
+  NIM,
+  NAMA,
+  DIVISI,
+  TANGGAL_MASUK,
+  JUDUL,
+  ROLE,
+  COUNT
+};
+
+/**
+ * @brief The names of the columns, in the order of the Column enum.
+ * The table and its strings are constant, so they stay in flash.
+ */
+static constexpr const char *const COLUMN_NAMES[] = {
+    "uid", "nim", "nama", "divisi", "tanggal_masuk", "judul", "role",
+};
+
+static_assert(sizeof(COLUMN_NAMES) / sizeof(COLUMN_NAMES[0]) ==
+                  (size_t)Column::COUNT,
+              "Every column needs a name in COLUMN_NAMES");
+
+/**
+ * @brief Gets the name of a column as used by the API.
+ *
+ * @param column The column to get the name of.
+ * @return The name of the column, kept in flash.
+ */
+constexpr const char *columnName(Column column) {
+  return COLUMN_NAMES[(size_t)column];
+}
+
+/**
+ * @brief Writes a column as a JSON object key, using its name.
+ * Lets a map keyed by columns be written as a JSON object.
+ *
+ * @param out The sink to write to.
+ * @param column The column to write.
+ * @return The number of bytes written.
+ */
+inline size_t printJsonKey(Print &out, Column column) {
+  return printJsonString(out, columnName(column));
+}
+
+/**
+ * @brief Gets the text a column is stored under in a JSON object, its name.
+ * Lets the collection helpers convert a map keyed by columns.
+ *
+ * @param column The column to convert.
+ * @return The name of the column, kept in flash.
+ */
+inline const char *jsonKeyText(Column column) { return columnName(column); }
+
+// Number of entries a column map holds without growing
+#define COLUMN_MAP_CAPACITY 8
+
+// Number of pooled arrays shared by the column maps
+#define COLUMN_POOL_BLOCKS 16
+
+/**
+ * @brief Allocator of the column maps passed to and returned by PostmanAPI.
+ * These maps only live for a single request, so their key and value arrays
+ * are taken from a fixed pool instead of the heap.
+ */
+using ColumnPool =
+    FixedBlockPool<COLUMN_MAP_CAPACITY * sizeof(String), COLUMN_POOL_BLOCKS>;
+using ColumnAllocator = PoolAllocator<ColumnPool>;
+
+/**
+ * @brief Map of column values used by the PostmanAPI requests.
+ * The maps hold a handful of columns, so they're flat maps of two arrays,
+ * keyed by column ID.
+ */
+using ColumnMap = FlatMap<Column, String, ColumnAllocator>;
+
+#endif
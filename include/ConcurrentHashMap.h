@@ -0,0 +1,225 @@
+#ifndef CONCURRENTHASHMAP_H
+#define CONCURRENTHASHMAP_H
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+// Import package for Data Collections
+#include <HashMap.h>
+
+/**
+ * @brief A hash map that can be shared between tasks.
+ * The entries are spread over S stripes by the high bits of their hash, and
+ * every stripe is a HashMap guarded by its own lock. Two tasks only wait for
+ * each other when their keys fall into the same stripe, and a lock is only
+ * held for a single lookup or update.
+ *
+ * Values are returned by copy, never by reference, so a value can't change
+ * or disappear while a task is still reading it. Use @ref compute to change
+ * a value in place, such as incrementing a counter.
+ *
+ * @tparam K The type of the key.
+ * @tparam V The type of the value.
+ * @tparam H The hasher of the key, see Hash.h.
+ * @tparam S The number of stripes, a power of two up to 256.
+ */
+template <typename K, typename V, typename H = Hash<K>, size_t S = 8>
+class ConcurrentHashMap {
+  static_assert(S > 0 && S <= 256 && (S & (S - 1)) == 0,
+                "ConcurrentHashMap needs a power-of-two stripe count");
+
+  private:
+  /**
+   * @brief A part of the map with its own lock.
+   */
+  struct Stripe {
+    std::mutex lock;
+    HashMap<K, V, H> map;
+  };
+
+  Stripe stripes[S];
+  // Number of entries over all stripes, kept apart so size() takes no lock
+  std::atomic<size_t> count;
+  H hasher;
+
+  /**
+   * @brief Gets the stripe that holds the given key.
+   * The bucket of a key in the stripe's HashMap is chosen by the low bits of
+   * its hash, so the stripe is chosen by the high bits to keep both
+   * independent.
+   *
+   * @param key The key to look up.
+   * @return The stripe of the key.
+   */
+  Stripe &stripeOf(const K &key) {
+    return stripes[(hasher(key) >> 24) & (S - 1)];
+  }
+
+  public:
+  /**
+   * @brief Constructor for the ConcurrentHashMap class.
+   * Creates an empty map, the stripes allocate their buckets on first use.
+   */
+  ConcurrentHashMap() : count(0) {}
+
+  ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+  ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+  /**
+   * @brief Inserts a key-value pair into the map.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to insert or update.
+   * @param value The value associated with the key.
+   */
+  void put(const K &key, const V &value) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    size_t before = stripe.map.size();
+    stripe.map.put(key, value);
+    count += stripe.map.size() - before;
+  }
+
+  /**
+   * @brief Inserts a key-value pair only if the key doesn't exist yet.
+   *
+   * @param key The key to insert.
+   * @param value The value associated with the key.
+   * @return True if the pair was inserted, false if the key already existed.
+   */
+  bool putIfAbsent(const K &key, const V &value) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    if (stripe.map.containsKey(key))
+      return false;
+    stripe.map.put(key, value);
+    count++;
+    return true;
+  }
+
+  /**
+   * @brief Copies the value associated with the given key.
+   *
+   * @param key The key to search for.
+   * @param value Receives a copy of the value. Left untouched if not found.
+   * @return True if the key was found, false otherwise.
+   */
+  bool get(const K &key, V &value) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    const V *found = stripe.map.find(key);
+    if (found == nullptr)
+      return false;
+    value = *found;
+    return true;
+  }
+
+  /**
+   * @brief Retrieves the value associated with the given key, or a default
+   * value if the key does not exist.
+   *
+   * @param key The key to search for.
+   * @param defaultValue The value to return if the key is not found.
+   * @return A copy of the value, or the default value if not found.
+   */
+  V getOrDefault(const K &key, const V &defaultValue) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    return stripe.map.getOrDefault(key, defaultValue);
+  }
+
+  /**
+   * @brief Changes the value of a key in place while its stripe is locked.
+   * If the key does not exist, a default-constructed value is inserted
+   * first. The callback must be short and must not use this map.
+   *
+   * @code
+   * tapCounts.compute(uid, [](int &taps) { taps++; });
+   * @endcode
+   *
+   * @param key The key of the value to change.
+   * @param callback The function called with a reference to the value.
+   */
+  template <typename Callback> void compute(const K &key, Callback callback) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    V *value = stripe.map.find(key);
+    if (value == nullptr) {
+      value = &stripe.map.emplace(key);
+      count++;
+    }
+    callback(*value);
+  }
+
+  /**
+   * @brief Checks if the map contains the specified key.
+   *
+   * @param key The key to check for existence.
+   * @return True if the key exists, false otherwise.
+   */
+  bool containsKey(const K &key) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    return stripe.map.containsKey(key);
+  }
+
+  /**
+   * @brief Removes the entry with the specified key from the map.
+   *
+   * @param key The key of the entry to remove.
+   * @return True if the entry was removed, false if the key was not found.
+   */
+  bool remove(const K &key) {
+    Stripe &stripe = stripeOf(key);
+    std::lock_guard<std::mutex> guard(stripe.lock);
+    if (!stripe.map.remove(key))
+      return false;
+    count--;
+    return true;
+  }
+
+  /**
+   * @brief Clears all entries in the map, one stripe at a time.
+   * Entries put into an already cleared stripe during the call are kept.
+   */
+  void clear() {
+    for (size_t i = 0; i < S; i++) {
+      std::lock_guard<std::mutex> guard(stripes[i].lock);
+      count -= stripes[i].map.size();
+      stripes[i].map.clear();
+    }
+  }
+
+  /**
+   * @brief Returns the number of entries in the map without locking.
+   * While other tasks are writing, the result may already be stale.
+   *
+   * @return The number of entries in the map.
+   */
+  size_t size() const { return count.load(); }
+
+  /**
+   * @brief Checks if the map is empty without locking.
+   *
+   * @return True if the map has no entries, false otherwise.
+   */
+  bool isEmpty() const { return size() == 0; }
+
+  /**
+   * @brief Iterates over each key-value pair, one stripe at a time.
+   * Each stripe is locked while its entries are visited, so the callback
+   * sees a consistent stripe but not a snapshot of the whole map. The
+   * callback must not use this map.
+   *
+   * @param callback The function to call for each key-value pair.
+   */
+  template <typename Callback> void foreach (Callback callback) {
+    for (size_t i = 0; i < S; i++) {
+      std::lock_guard<std::mutex> guard(stripes[i].lock);
+      stripes[i].map.foreach (callback);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,401 @@
+#ifndef FLATMAP_H
+#define FLATMAP_H
+
+#include <string.h>
+#include <utility>
+
+// Import package for Data Collections
+#include <ArrayList.h>
+#include <HashMap.h>
+
+/**
+ * @brief Orders two keys of a flat map.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if a sorts before b, false otherwise.
+ */
+template <typename T> inline bool keyLess(const T &a, const T &b) {
+  return a < b;
+}
+
+/**
+ * @brief Orders two C-string keys by their characters.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if a sorts before b, false otherwise.
+ */
+inline bool keyLess(const char *a, const char *b) { return strcmp(a, b) < 0; }
+
+/**
+ * @brief A map for a handful of key-value pairs, stored in two arrays.
+ * The keys are kept sorted in one contiguous array and the values in a
+ * second array at the same positions, so a map of a few entries is two
+ * allocations instead of one per entry, and a lookup is a binary search over
+ * adjacent keys. Inserting and removing shift the later entries, which is
+ * cheap for the small maps this class is meant for. Use a HashMap for maps
+ * that grow large.
+ *
+ * The map is recognised as a HashMap by the collection type traits, so it
+ * can be written as JSON and passed wherever a map is expected.
+ * @ref foreach visits the entries in key order, not in insertion order.
+ *
+ * @tparam K The type of the key, ordered by keyLess.
+ * @tparam V The type of the value.
+ * @tparam A The allocator of both arrays, see Allocator.h.
+ */
+template <typename K, typename V, typename A = HeapAllocator> class FlatMap {
+  private:
+  ArrayList<K, A> keys;
+  ArrayList<V, A> values;
+
+  /**
+   * @brief Finds the position of the first key that isn't before the given
+   * key, which is where the key is or would be inserted.
+   *
+   * @param key The key to search for.
+   * @return The position of the key, between 0 and the size.
+   */
+  size_t lowerBound(const K &key) const {
+    size_t low = 0;
+    size_t high = keys.size();
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (keyLess(keys.get(middle), key)) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Finds the position of the given key.
+   *
+   * @param key The key to search for.
+   * @param index Receives the position of the key, or where it would be
+   * inserted.
+   * @return True if the key exists, false otherwise.
+   */
+  bool locate(const K &key, size_t &index) const {
+    index = lowerBound(key);
+    return index < keys.size() && keyEquals(keys.get(index), key);
+  }
+
+  /**
+   * @brief Inserts or updates a key-value pair.
+   *
+   * @param key The key, copied or moved into the map if it's new.
+   * @param value The value, copied or moved into the map.
+   */
+  template <typename KeyT, typename ValueT>
+  void putEntry(KeyT &&key, ValueT &&value) {
+    size_t index;
+    if (locate(key, index)) {
+      values.get(index) = std::forward<ValueT>(value);
+      return;
+    }
+    keys.add(index, K(std::forward<KeyT>(key)));
+    values.add(index, V(std::forward<ValueT>(value)));
+  }
+
+  public:
+  using key_type = K;
+  using mapped_type = V;
+  using is_hashmap = void;
+  // Position of a walk over the entries, see foreachFrom
+  using Cursor = size_t;
+
+  /**
+   * @brief Constructor for the FlatMap class.
+   * Creates an empty map, the arrays are allocated by the first put.
+   *
+   * @param allocator The allocator of the key and value arrays.
+   */
+  FlatMap(const A &allocator = A())
+      : keys(0, allocator), values(0, allocator) {}
+
+  /**
+   * @brief Makes room for at least the given number of entries.
+   *
+   * @param minCapacity The number of entries the map should hold.
+   */
+  void reserve(size_t minCapacity) {
+    keys.reserve(minCapacity);
+    values.reserve(minCapacity);
+  }
+
+  /**
+   * @brief Inserts a key-value pair into the map.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to insert or update.
+   * @param value The value associated with the key.
+   */
+  void put(const K &key, const V &value) { putEntry(key, value); }
+
+  /**
+   * @brief Inserts a key-value pair into the map by moving the value.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to insert or update.
+   * @param value The value to move into the map.
+   */
+  void put(const K &key, V &&value) { putEntry(key, std::move(value)); }
+
+  /**
+   * @brief Inserts a key-value pair into the map by moving both.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to move into the map.
+   * @param value The value to move into the map.
+   */
+  void put(K &&key, V &&value) { putEntry(std::move(key), std::move(value)); }
+
+  /**
+   * @brief Constructs the value of a key in place.
+   * If the key already exists, its value is replaced by the new one.
+   *
+   * @param key The key to insert or update.
+   * @param args The arguments passed to the value's constructor.
+   * @return A reference to the value in the map.
+   */
+  template <typename... Args> V &emplace(const K &key, Args &&...args) {
+    size_t index;
+    if (locate(key, index)) {
+      values.get(index) = V(std::forward<Args>(args)...);
+    } else {
+      keys.add(index, key);
+      values.add(index, V(std::forward<Args>(args)...));
+    }
+    return values.get(index);
+  }
+
+  /**
+   * @brief Updates the value associated with the given key.
+   * If the key does not exist, it will insert a new key-value pair.
+   *
+   * @param key The key to update or insert.
+   * @param newValue The new value to associate with the key.
+   */
+  void update(const K &key, const V &newValue) { put(key, newValue); }
+
+  /**
+   * @brief Retrieves the value associated with the given key.
+   * If the key does not exist, it returns a default-constructed value.
+   *
+   * @param key The key to search for.
+   * @return The value associated with the key, or a default value if not found.
+   */
+  V get(const K &key) const {
+    const V *value = find(key);
+    return value ? *value : V();
+  }
+
+  /**
+   * @brief Finds the value associated with the given key.
+   * Unlike @ref get, this method doesn't copy the value, and the value
+   * can be changed in place. The pointer is valid until the next put or
+   * remove.
+   *
+   * @param key The key to search for.
+   * @return A pointer to the value in the map, or nullptr if not found.
+   */
+  V *find(const K &key) {
+    size_t index;
+    return locate(key, index) ? &values.get(index) : nullptr;
+  }
+
+  /**
+   * @brief Finds the value associated with the given key.
+   * Unlike @ref get, this method doesn't copy the value.
+   *
+   * @param key The key to search for.
+   * @return A pointer to the value in the map, or nullptr if not found.
+   */
+  const V *find(const K &key) const {
+    size_t index;
+    return locate(key, index) ? &values.get(index) : nullptr;
+  }
+
+  /**
+   * @brief Retrieves the value associated with the given key, or a default
+   * value if the key does not exist.
+   *
+   * @param key The key to search for.
+   * @param defaultValue The value to return if the key is not found.
+   * @return The value associated with the key, or the default value if not
+   * found.
+   */
+  V getOrDefault(const K &key, const V &defaultValue) const {
+    const V *value = find(key);
+    return value ? *value : defaultValue;
+  }
+
+  /**
+   * @brief Checks if the map contains the specified key.
+   *
+   * @param key The key to check for existence.
+   * @return True if the key exists, false otherwise.
+   */
+  bool containsKey(const K &key) const { return find(key) != nullptr; }
+
+  /**
+   * @brief Checks if the map contains the specified value.
+   *
+   * @param value The value to check for existence.
+   * @return True if the value exists, false otherwise.
+   */
+  bool containsValue(const V &value) const { return values.contains(value); }
+
+  /**
+   * @brief Removes the entry with the specified key from the map.
+   *
+   * @param key The key of the entry to remove.
+   * @return True if the entry was removed, false if the key was not found.
+   */
+  bool remove(const K &key) {
+    size_t index;
+    if (!locate(key, index)) {
+      return false;
+    }
+    keys.remove(index);
+    values.remove(index);
+    return true;
+  }
+
+  /**
+   * @brief Checks if the map is empty.
+   *
+   * @return True if the map is empty, false otherwise.
+   */
+  bool isEmpty() const { return keys.isEmpty(); }
+
+  /**
+   * @brief Clears all entries in the map.
+   * The arrays are kept for the next entries.
+   */
+  void clear() {
+    keys.clear();
+    values.clear();
+  }
+
+  /**
+   * @brief Returns the number of entries in the map.
+   *
+   * @return The number of entries in the map.
+   */
+  size_t size() const { return keys.size(); }
+
+#ifdef ENABLE_COLLECTION_STATS
+  /**
+   * @brief Names this map in the collection stats report.
+   * The key and value arrays are reported as two lines with this name.
+   *
+   * @param label The name of the map, must outlive it.
+   */
+  void setStatsLabel(const char *label) {
+    keys.setStatsLabel(label);
+    values.setStatsLabel(label);
+  }
+#endif
+
+  /**
+   * @brief Iterates over each key-value pair in the map.
+   * The entries are visited in key order.
+   *
+   * @param callback The function to call for each key-value pair.
+   */
+  template <typename Callback> void foreach (Callback callback) const {
+    for (size_t i = 0; i < keys.size(); i++) {
+      callback(keys.get(i), values.get(i));
+    }
+  }
+
+  /**
+   * @brief Gets the position of the first entry, to start a walk with
+   * @ref foreachFrom.
+   *
+   * @return The position of the first entry in key order.
+   */
+  Cursor cursor() const { return 0; }
+
+  /**
+   * @brief Iterates over the key-value pairs from a position on.
+   * The position moves past every entry the callback accepts, so a walk
+   * that stopped can be resumed without visiting the earlier entries again.
+   * The map must not change in between.
+   *
+   * @param cursor The position to start from, left where the walk stopped.
+   * @param callback The function to call for each key-value pair. Returning
+   * false stops the walk at that entry.
+   */
+  template <typename Callback>
+  void foreachFrom(Cursor &cursor, Callback callback) const {
+    while (cursor < keys.size() &&
+           callback(keys.get(cursor), values.get(cursor))) {
+      cursor++;
+    }
+  }
+
+  /**
+   * @brief Writes the map as a JSON object to a Print.
+   *
+   * @param out The sink to write to.
+   * @return The number of bytes written.
+   */
+  size_t printJsonTo(Print &out) const { return printJsonValue(out, *this); }
+
+  /**
+   * @brief Measures the length of the JSON text of the map.
+   *
+   * @return The number of bytes @ref printJsonTo writes.
+   */
+  size_t measureJsonLength() const { return measureJsonValue(*this); }
+
+#ifdef ENABLE_COLLECTION_HELPERS
+  /**
+   * @brief Converts the map to a JSON document.
+   *
+   * @return A JsonDocument representing the map.
+   */
+  JsonDocument toJson() const {
+    JsonDocument doc;
+    JsonObject data = doc.to<JsonObject>();
+
+    foreach ([&data](const K &key, const V &value) {
+      assignToJsonObject(data, key, value);
+    })
+      ;
+
+    return doc;
+  }
+
+  /**
+   * @brief Converts the map to a string representation.
+   *
+   * @return A string representation of the map.
+   */
+  String toString() const {
+    String result = "{";
+    bool first = true;
+
+    foreach ([&result, &first](const K &key, const V &value) {
+      if (!first) {
+        result += ", ";
+      }
+      first = false;
+      result += "\"" + String(jsonKeyText(key)) + "\": \"" + String(value) +
+                "\"";
+    })
+      ;
+
+    result += "}";
+    return result;
+  }
+#endif
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * @brief Computes the FNV-1a hash of a byte range.
+ * FNV-1a is short and fast on the ESP32, and spreads the short keys used on
+ * the device (column names, card UIDs) well enough for a hash table.
+ *
+ * @param data The bytes to hash.
+ * @param length The number of bytes to hash.
+ * @return The 32-bit hash of the bytes.
+ */
+inline uint32_t fnv1a(const char *data, size_t length) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+/**
+ * @brief Default hasher used by the hash based collections.
+ * This template is specialised for every supported key type. A custom key
+ * type can either specialise it, or the collection can be given another
+ * hasher type with a `uint32_t operator()(const K &) const`.
+ *
+ * @tparam T The type of the key.
+ */
+template <typename T, typename = void> struct Hash;
+
+/**
+ * @brief Mixes the bits of a 32-bit value.
+ * This is the finalizer of MurmurHash3: every input bit affects every output
+ * bit, so the low bits the hash tables pick their bucket with depend on the
+ * whole key. A plain multiplication doesn't do that, its low k bits only
+ * depend on the low k bits of the key.
+ *
+ * @param hash The value to mix.
+ * @return The mixed value.
+ */
+inline uint32_t fmix32(uint32_t hash) {
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6BUL;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35UL;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/**
+ * @brief Hasher for integer and enum keys.
+ * Folds keys wider than 32 bits, then mixes them with @ref fmix32, so keys
+ * that share their low bits (multiples of a power of two) still spread
+ * over the buckets.
+ */
+template <typename T>
+struct Hash<T, std::enable_if_t<std::is_integral<T>::value ||
+                                std::is_enum<T>::value>> {
+  uint32_t operator()(const T &key) const {
+    uint64_t value = (uint64_t)key;
+    return fmix32((uint32_t)value ^ (uint32_t)(value >> 32));
+  }
+};
+
+/**
+ * @brief Hasher for Arduino String keys.
+ * Hashes the characters in place, without copying the String.
+ */
+template <> struct Hash<String> {
+  uint32_t operator()(const String &key) const {
+    return fnv1a(key.c_str(), key.length());
+  }
+};
+
+/**
+ * @brief Hasher for C-string keys.
+ * Hashes the characters the pointer refers to, not the pointer itself.
+ */
+template <> struct Hash<const char *> {
+  uint32_t operator()(const char *key) const {
+    return fnv1a(key, strlen(key));
+  }
+};
+
+/**
+ * @brief Compares two keys of a hash based collection.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if both keys are equal, false otherwise.
+ */
+template <typename T> inline bool keyEquals(const T &a, const T &b) {
+  return a == b;
+}
+
+/**
+ * @brief Compares two C-string keys by their characters.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if both keys contain the same characters, false otherwise.
+ */
+inline bool keyEquals(const char *a, const char *b) {
+  return a == b || strcmp(a, b) == 0;
+}
+
+#endif
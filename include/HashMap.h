@@ -1,16 +1,39 @@
 #ifndef HASHMAP_H
 #define HASHMAP_H
 
+// The collection helpers (toJson, toString) depend on ArduinoJson. Define
+// DISABLE_COLLECTION_HELPERS to build the collections without it, for
+// example in a host build
+#ifndef DISABLE_COLLECTION_HELPERS
 #define ENABLE_COLLECTION_HELPERS
+#endif
 
+#ifdef ENABLE_COLLECTION_HELPERS
 #include <ArduinoJson.h>
+#endif
+#include <new>
+#include <utility>
+
+// Import allocators for the hash table entries and buckets
+#include <Allocator.h>
+
+// Import hashers for the hash table buckets
+#include <Hash.h>
 
 // Import type traits for checking if a type is an ArrayList or HashMap
 #include <TypeTraits.h>
 
+// Import JSON writer for streaming the hash map to a Print
+#include <JsonWriter.h>
+
+// Import collection stats for the allocation counters
+#include <CollectionStats.h>
+
 /**
  * @brief Represents a single entry in the hash map.
- * Each entry contains a key-value pair and a pointer to the next entry.
+ * Each entry contains a key-value pair, the pointers to the previous and
+ * next entry in insertion order, and a pointer to the next entry in the
+ * same bucket.
  *
  * @tparam K The type of the key.
  * @tparam V The type of the value.
@@ -19,31 +42,213 @@ template <typename K, typename V> struct HashEntry {
   K key;
   V value;
   HashEntry *next;
+  HashEntry *prev;
+  HashEntry *chain;
+  uint32_t hash;
 };
 
 /**
  * @brief A hash map class for storing key-value pairs.
  * This class provides a simple implementation of a hash map
  * that allows for efficient storage and retrieval of key-value pairs.
+ * Entries are chained into a power-of-two bucket array that doubles when
+ * the load factor exceeds 3/4, and are also linked in insertion order,
+ * so @ref foreach visits the entries in the order they were put.
+ *
+ * @tparam K The type of the key.
+ * @tparam V The type of the value.
+ * @tparam H The hasher of the key, see Hash.h.
+ * @tparam A The allocator of the entries and the bucket array, see
+ * Allocator.h.
  *
  * @note This class is custom data collections class that inspired by Java's
  * HashMap.
  */
-template <typename K, typename V> class HashMap {
+template <typename K, typename V, typename H = Hash<K>,
+          typename A = HeapAllocator>
+class HashMap {
   private:
+  // Number of buckets allocated by the first put
+  static const size_t INITIAL_BUCKETS = 8;
+
   HashEntry<K, V> *head;
   HashEntry<K, V> *tail;
+  HashEntry<K, V> **buckets;
+  size_t bucketCount;
   size_t count = 0;
+  H hasher;
+  A allocator;
+#ifdef ENABLE_COLLECTION_STATS
+  // Mutable, so lookups through const methods are counted
+  mutable CollectionStats stats{"HashMap"};
+#endif
+
+  /**
+   * @brief Destroys an entry and gives its memory back to the allocator.
+   *
+   * @param entry The entry to free.
+   */
+  void freeEntry(HashEntry<K, V> *entry) {
+    entry->~HashEntry<K, V>();
+    allocator.deallocate(entry, sizeof(HashEntry<K, V>));
+  }
+
+  /**
+   * @brief Gives the bucket array back to the allocator.
+   */
+  void freeBuckets() {
+    if (buckets != nullptr) {
+      allocator.deallocate(buckets, bucketCount * sizeof(HashEntry<K, V> *));
+    }
+    buckets = nullptr;
+    bucketCount = 0;
+  }
+
+  /**
+   * @brief Finds the entry with the given key.
+   *
+   * @param key The key to search for.
+   * @param hash The hash of the key.
+   * @return The entry with the key, or nullptr if not found.
+   */
+  HashEntry<K, V> *findEntry(const K &key, uint32_t hash) const {
+    if (bucketCount == 0) {
+      return nullptr;
+    }
+
+    HashEntry<K, V> *current = buckets[hash & (bucketCount - 1)];
+#ifdef ENABLE_COLLECTION_STATS
+    size_t probes = 0;
+#endif
+    while (current) {
+#ifdef ENABLE_COLLECTION_STATS
+      probes++;
+#endif
+      if (current->hash == hash && keyEquals(current->key, key)) {
+        break;
+      }
+      current = current->chain;
+    }
+#ifdef ENABLE_COLLECTION_STATS
+    stats.recordLookup(probes);
+#endif
+    return current;
+  }
+
+  /**
+   * @brief Resizes the bucket array and redistributes the entries.
+   * The entries themselves aren't moved or copied, only relinked.
+   *
+   * @param newBucketCount The new number of buckets, a power of two.
+   */
+  void rehash(size_t newBucketCount) {
+    HashEntry<K, V> **newBuckets = static_cast<HashEntry<K, V> **>(
+        allocator.allocate(newBucketCount * sizeof(HashEntry<K, V> *)));
+    for (size_t i = 0; i < newBucketCount; i++) {
+      newBuckets[i] = nullptr;
+    }
+
+    HashEntry<K, V> *current = head;
+    while (current) {
+      size_t index = current->hash & (newBucketCount - 1);
+      current->chain = newBuckets[index];
+      newBuckets[index] = current;
+      current = current->next;
+    }
+
+    freeBuckets();
+    buckets = newBuckets;
+    bucketCount = newBucketCount;
+#ifdef ENABLE_COLLECTION_STATS
+    stats.recordAllocation(newBucketCount * sizeof(HashEntry<K, V> *));
+    stats.recordResize(newBucketCount);
+#endif
+  }
+
+  /**
+   * @brief Inserts a new entry for a key that isn't in the map yet.
+   *
+   * @param key The key to insert.
+   * @param value The value associated with the key.
+   * @param hash The hash of the key.
+   * @return The inserted entry.
+   */
+  template <typename KeyArg, typename ValueArg>
+  HashEntry<K, V> *insert(KeyArg &&key, ValueArg &&value, uint32_t hash) {
+    if (bucketCount == 0) {
+      rehash(INITIAL_BUCKETS);
+    } else if ((count + 1) * 4 > bucketCount * 3) {
+      rehash(bucketCount * 2);
+    }
+
+    void *memory = allocator.allocate(sizeof(HashEntry<K, V>));
+    HashEntry<K, V> *newEntry = new (memory)
+        HashEntry<K, V>{std::forward<KeyArg>(key),
+                        std::forward<ValueArg>(value), nullptr, tail, nullptr,
+                        hash};
+    if (!head) {
+      head = tail = newEntry;
+    } else {
+      tail->next = newEntry;
+      tail = newEntry;
+    }
+
+    size_t index = hash & (bucketCount - 1);
+    newEntry->chain = buckets[index];
+    buckets[index] = newEntry;
+    count++;
+#ifdef ENABLE_COLLECTION_STATS
+    stats.recordAllocation(sizeof(HashEntry<K, V>));
+#endif
+    return newEntry;
+  }
+
+  /**
+   * @brief Inserts or updates a key-value pair, forwarding both arguments.
+   *
+   * @param key The key to insert or update.
+   * @param value The value associated with the key.
+   */
+  template <typename KeyArg, typename ValueArg>
+  void putEntry(KeyArg &&key, ValueArg &&value) {
+    uint32_t hash = hasher(key);
+    HashEntry<K, V> *entry = findEntry(key, hash);
+    if (entry) {
+      entry->value = std::forward<ValueArg>(value);
+      return;
+    }
+    insert(std::forward<KeyArg>(key), std::forward<ValueArg>(value), hash);
+  }
 
   public:
+  using key_type = K;
   using mapped_type = V;
   using is_hashmap = void;
+  // Position of a walk over the entries, see foreachFrom
+  using Cursor = const HashEntry<K, V> *;
 
   /**
    * @brief Default constructor for the HashMap.
    * Initializes an empty hash map with no entries.
+   * The bucket array is allocated by the first put.
+   *
+   * @param allocator The allocator of the entries and the bucket array.
+   */
+  HashMap(const A &allocator = A())
+      : head(nullptr), tail(nullptr), buckets(nullptr), bucketCount(0),
+        allocator(allocator) {}
+
+  /**
+   * @brief Constructor for the HashMap with a hasher.
+   * Initializes an empty hash map that places its keys with the given
+   * hasher, for hashers that carry state such as a seed.
+   *
+   * @param hasher The hasher of the keys.
+   * @param allocator The allocator of the entries and the bucket array.
    */
-  HashMap() : head(nullptr), tail(nullptr) {}
+  HashMap(const H &hasher, const A &allocator = A())
+      : head(nullptr), tail(nullptr), buckets(nullptr), bucketCount(0),
+        hasher(hasher), allocator(allocator) {}
 
   /**
    * @brief Copy constructor for the HashMap.
@@ -51,7 +256,12 @@ template <typename K, typename V> class HashMap {
    *
    * @param other The hash map to copy from.
    */
-  HashMap(const HashMap &other) : head(nullptr), tail(nullptr) {
+  HashMap(const HashMap &other)
+      : head(nullptr), tail(nullptr), buckets(nullptr), bucketCount(0),
+        hasher(other.hasher), allocator(other.allocator) {
+#ifdef ENABLE_COLLECTION_STATS
+    stats.setLabel(other.stats.getLabel());
+#endif
     other.foreach (
         [this](const K &key, const V &value) { this->put(key, value); });
   }
@@ -72,11 +282,63 @@ template <typename K, typename V> class HashMap {
     return *this;
   }
 
+  /**
+   * @brief Move constructor for the HashMap.
+   * Takes over the entries of another hash map without copying them.
+   * The other hash map is left empty.
+   *
+   * @param other The hash map to move from.
+   */
+  HashMap(HashMap &&other)
+      : head(other.head), tail(other.tail), buckets(other.buckets),
+        bucketCount(other.bucketCount), count(other.count),
+        hasher(other.hasher), allocator(other.allocator) {
+#ifdef ENABLE_COLLECTION_STATS
+    stats.setLabel(other.stats.getLabel());
+#endif
+    other.head = other.tail = nullptr;
+    other.buckets = nullptr;
+    other.bucketCount = 0;
+    other.count = 0;
+  }
+
+  /**
+   * @brief Move assignment operator for the HashMap.
+   * Takes over the entries of another hash map without copying them,
+   * together with the hasher they were placed by and the allocator they
+   * were allocated by.
+   * The other hash map is left empty.
+   *
+   * @param other The hash map to move from.
+   * @return A reference to this hash map.
+   */
+  HashMap &operator=(HashMap &&other) {
+    if (this != &other) {
+      clear();
+      freeBuckets();
+      hasher = other.hasher;
+      allocator = other.allocator;
+      head = other.head;
+      tail = other.tail;
+      buckets = other.buckets;
+      bucketCount = other.bucketCount;
+      count = other.count;
+      other.head = other.tail = nullptr;
+      other.buckets = nullptr;
+      other.bucketCount = 0;
+      other.count = 0;
+    }
+    return *this;
+  }
+
   /**
    * @brief Destructor for the HashMap.
    * Cleans up all entries in the hash map to prevent memory leaks.
    */
-  ~HashMap() { clear(); }
+  ~HashMap() {
+    clear();
+    freeBuckets();
+  }
 
   /**
    * @brief Inserts a key-value pair into the hash map.
@@ -85,15 +347,44 @@ template <typename K, typename V> class HashMap {
    * @param key The key to insert or update.
    * @param value The value associated with the key.
    */
-  void put(const K &key, const V &value) {
-    HashEntry<K, V> *newEntry = new HashEntry<K, V>{key, value, nullptr};
-    if (!head) {
-      head = tail = newEntry;
-    } else {
-      tail->next = newEntry;
-      tail = newEntry;
+  void put(const K &key, const V &value) { putEntry(key, value); }
+
+  /**
+   * @brief Inserts a key-value pair into the hash map by moving the value.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to insert or update.
+   * @param value The value to move into the hash map.
+   */
+  void put(const K &key, V &&value) { putEntry(key, std::move(value)); }
+
+  /**
+   * @brief Inserts a key-value pair into the hash map by moving both.
+   * If the key already exists, it will update the value.
+   *
+   * @param key The key to move into the hash map.
+   * @param value The value to move into the hash map.
+   */
+  void put(K &&key, V &&value) {
+    putEntry(std::move(key), std::move(value));
+  }
+
+  /**
+   * @brief Constructs the value of a key in place.
+   * If the key already exists, its value is replaced by the new one.
+   *
+   * @param key The key to insert or update.
+   * @param args The arguments passed to the value's constructor.
+   * @return A reference to the value in the hash map.
+   */
+  template <typename... Args> V &emplace(const K &key, Args &&...args) {
+    uint32_t hash = hasher(key);
+    HashEntry<K, V> *entry = findEntry(key, hash);
+    if (entry) {
+      entry->value = V(std::forward<Args>(args)...);
+      return entry->value;
     }
-    count++;
+    return insert(key, V(std::forward<Args>(args)...), hash)->value;
   }
 
   /**
@@ -103,18 +394,7 @@ template <typename K, typename V> class HashMap {
    * @param key The key to update or insert.
    * @param newValue The new value to associate with the key.
    */
-  void update(const K &key, const V &newValue) {
-    HashEntry<K, V> *current = head;
-    while (current) {
-      if (current->key == key) {
-        current->value = newValue;
-        return;
-      }
-      current = current->next;
-    }
-    // If key doesn't exist, insert it
-    put(key, newValue);
-  }
+  void update(const K &key, const V &newValue) { put(key, newValue); }
 
   /**
    * @brief Retrieves the value associated with the given key.
@@ -123,17 +403,39 @@ template <typename K, typename V> class HashMap {
    * @param key The key to search for.
    * @return The value associated with the key, or a default value if not found.
    */
-  V get(const K &key) {
-    HashEntry<K, V> *current = head;
-    while (current) {
-      if (current->key == key) {
-        return current->value;
-      }
-      current = current->next;
+  V get(const K &key) const {
+    HashEntry<K, V> *entry = findEntry(key, hasher(key));
+    if (entry) {
+      return entry->value;
     }
     return V();
   }
 
+  /**
+   * @brief Finds the value associated with the given key.
+   * Unlike @ref get, this method doesn't copy the value, and the value
+   * can be changed in place.
+   *
+   * @param key The key to search for.
+   * @return A pointer to the value in the hash map, or nullptr if not found.
+   */
+  V *find(const K &key) {
+    HashEntry<K, V> *entry = findEntry(key, hasher(key));
+    return entry ? &entry->value : nullptr;
+  }
+
+  /**
+   * @brief Finds the value associated with the given key.
+   * Unlike @ref get, this method doesn't copy the value.
+   *
+   * @param key The key to search for.
+   * @return A pointer to the value in the hash map, or nullptr if not found.
+   */
+  const V *find(const K &key) const {
+    HashEntry<K, V> *entry = findEntry(key, hasher(key));
+    return entry ? &entry->value : nullptr;
+  }
+
   /**
    * @brief Retrieves the value associated with the given key, or a default
    * value if the key does not exist.
@@ -143,34 +445,23 @@ template <typename K, typename V> class HashMap {
    * @return The value associated with the key, or the default value if not
    * found.
    */
-  V getOrDefault(const K &key, const V &defaultValue) {
-    HashEntry<K, V> *current = head;
-    while (current) {
-      if (current->key == key) {
-        return current->value;
-      }
-      current = current->next;
+  V getOrDefault(const K &key, const V &defaultValue) const {
+    HashEntry<K, V> *entry = findEntry(key, hasher(key));
+    if (entry) {
+      return entry->value;
     }
     return defaultValue;
   }
 
   /**
    * @brief Checks if the hash map contains the specified key.
-   * This method iterates through the entries in the hash map
-   * to determine if the key exists.
+   * This method looks the key up in its bucket.
    *
    * @param key The key to check for existence.
    * @return True if the key exists, false otherwise.
    */
   bool containsKey(const K &key) const {
-    HashEntry<K, V> *current = head;
-    while (current) {
-      if (current->key == key) {
-        return true;
-      }
-      current = current->next;
-    }
-    return false;
+    return findEntry(key, hasher(key)) != nullptr;
   }
 
   /**
@@ -201,22 +492,32 @@ template <typename K, typename V> class HashMap {
    * @return True if the entry was removed, false if the key was not found.
    */
   bool remove(const K &key) {
-    HashEntry<K, V> *current = head;
-    HashEntry<K, V> *previous = nullptr;
+    if (bucketCount == 0) {
+      return false;
+    }
 
-    while (current) {
-      if (current->key == key) {
-        if (previous) {
-          previous->next = current->next;
+    uint32_t hash = hasher(key);
+    HashEntry<K, V> **link = &buckets[hash & (bucketCount - 1)];
+    while (*link) {
+      HashEntry<K, V> *current = *link;
+      if (current->hash == hash && keyEquals(current->key, key)) {
+        *link = current->chain;
+
+        if (current->prev) {
+          current->prev->next = current->next;
         } else {
           head = current->next;
         }
+        if (current->next) {
+          current->next->prev = current->prev;
+        } else {
+          tail = current->prev;
+        }
         count--;
-        delete current;
+        freeEntry(current);
         return true;
       }
-      previous = current;
-      current = current->next;
+      link = &current->chain;
     }
     return false;
   }
@@ -234,13 +535,17 @@ template <typename K, typename V> class HashMap {
    * @brief Clears all entries in the hash map.
    * This method removes all entries from the hash map,
    * effectively resetting it to an empty state.
+   * The bucket array is kept for the next entries.
    */
   void clear() {
     HashEntry<K, V> *current = head;
     while (current != nullptr) {
       HashEntry<K, V> *toDelete = current;
       current = current->next;
-      delete toDelete;
+      freeEntry(toDelete);
+    }
+    for (size_t i = 0; i < bucketCount; i++) {
+      buckets[i] = nullptr;
     }
     head = tail = nullptr;
     count = 0;
@@ -254,10 +559,20 @@ template <typename K, typename V> class HashMap {
    */
   size_t size() const { return count; }
 
+#ifdef ENABLE_COLLECTION_STATS
+  /**
+   * @brief Names this hash map in the collection stats report.
+   *
+   * @param label The name of the hash map, must outlive it.
+   */
+  void setStatsLabel(const char *label) { stats.setLabel(label); }
+#endif
+
   /**
    * @brief Iterates over each key-value pair in the hash map.
    * This method allows you to perform an operation on each entry
    * in the hash map using a callback function.
+   * The entries are visited in insertion order.
    *
    * @param callback The function to call for each key-value pair.
    */
@@ -269,6 +584,48 @@ template <typename K, typename V> class HashMap {
     }
   }
 
+  /**
+   * @brief Gets the position of the first entry, to start a walk with
+   * @ref foreachFrom.
+   *
+   * @return The position of the first entry in insertion order.
+   */
+  Cursor cursor() const { return head; }
+
+  /**
+   * @brief Iterates over the key-value pairs from a position on.
+   * The position moves past every entry the callback accepts, so a walk
+   * that stopped can be resumed without visiting the earlier entries again.
+   * The map must not change in between.
+   *
+   * @param cursor The position to start from, left where the walk stopped.
+   * @param callback The function to call for each key-value pair. Returning
+   * false stops the walk at that entry.
+   */
+  template <typename Callback>
+  void foreachFrom(Cursor &cursor, Callback callback) const {
+    while (cursor != nullptr && callback(cursor->key, cursor->value)) {
+      cursor = cursor->next;
+    }
+  }
+
+  /**
+   * @brief Writes the hash map as a JSON object to a Print.
+   * Unlike @ref toJson, this doesn't build a JsonDocument or a String: the
+   * text is written straight to the sink, such as Serial or an HTTP body.
+   *
+   * @param out The sink to write to.
+   * @return The number of bytes written.
+   */
+  size_t printJsonTo(Print &out) const { return printJsonValue(out, *this); }
+
+  /**
+   * @brief Measures the length of the JSON text of the hash map.
+   *
+   * @return The number of bytes @ref printJsonTo writes.
+   */
+  size_t measureJsonLength() const { return measureJsonValue(*this); }
+
 #ifdef ENABLE_COLLECTION_HELPERS
   /**
    * @brief Converts the hash map to a JSON document.
@@ -289,22 +646,24 @@ template <typename K, typename V> class HashMap {
         using ElementType = typename V::value_type;
         if constexpr (::is_hashmap<ElementType>::value ||
                       is_arraylist<ElementType>::value) {
+#ifdef ARDUINO
           Serial.println("Nested ArrayList/HashMap not supported in toJson()");
-          doc[key] = String("unsupported");
+#endif
+          doc[jsonKeyText(key)] = String("unsupported");
         } else {
-          JsonArray data = doc.createNestedArray(key);
+          JsonArray data = doc.createNestedArray(jsonKeyText(key));
           for (size_t i = 0; i < value.size(); i++) {
             data.add(value.get(i));
           }
         }
       } else if constexpr (::is_hashmap<V>::value) {
-        JsonObject data = doc.createNestedObject(key);
+        JsonObject data = doc.createNestedObject(jsonKeyText(key));
 
         value.foreach ([&data](const auto &key2, const auto &value2) {
           assignToJsonObject(data, key2, value2);
         });
       } else {
-        doc[key] = value;
+        doc[jsonKeyText(key)] = value;
       }
 
       current = current->next;
@@ -329,7 +688,8 @@ template <typename K, typename V> class HashMap {
         result += ", ";
       }
       first = false;
-      result += "\"" + String(key) + "\": \"" + String(value) + "\"";
+      result += "\"" + String(jsonKeyText(key)) + "\": \"" + String(value) +
+                "\"";
     })
       ;
 
@@ -339,6 +699,7 @@ template <typename K, typename V> class HashMap {
 #endif
 };
 
+#ifdef ENABLE_COLLECTION_HELPERS
 /**
  * @brief Assigns a value to a JSON object.
  * This function checks if the value is an ArrayList or HashMap,
@@ -357,11 +718,14 @@ template <typename K, typename V> class HashMap {
 template <typename KeyT, typename ValueT>
 void assignToJsonObject(JsonObject &obj, const KeyT &key, const ValueT &value) {
   if constexpr (is_arraylist<ValueT>::value || is_hashmap<ValueT>::value) {
+#ifdef ARDUINO
     Serial.println("Nested ArrayList/HashMap not supported in toJson()");
-    obj[key] = String("unsupported");
+#endif
+    obj[jsonKeyText(key)] = String("unsupported");
   } else {
-    obj[key] = value;
+    obj[jsonKeyText(key)] = value;
   }
 };
+#endif
 
 #endif
\ No newline at end of file
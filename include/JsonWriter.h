@@ -0,0 +1,405 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+// Import type traits for checking if a type is an ArrayList or HashMap
+#include <TypeTraits.h>
+
+/**
+ * @brief A Print that only counts the bytes written to it.
+ * Used to measure the length of a JSON text without building it.
+ */
+class CountingPrint : public Print {
+  private:
+  size_t count = 0;
+
+  public:
+  size_t write(uint8_t) override {
+    count++;
+    return 1;
+  }
+
+  size_t write(const uint8_t *, size_t size) override {
+    count += size;
+    return size;
+  }
+
+  /**
+   * @brief Gets the number of bytes written so far.
+   *
+   * @return The number of bytes written.
+   */
+  size_t length() const { return count; }
+};
+
+/**
+ * @brief Writes a JSON string, escaping the characters that need it.
+ * Runs of plain characters are written in one call.
+ *
+ * @param out The sink to write to.
+ * @param text The characters of the string.
+ * @param length The number of characters.
+ * @return The number of bytes written.
+ */
+inline size_t printJsonString(Print &out, const char *text, size_t length) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+
+  size_t written = out.write('"');
+  size_t start = 0;
+  for (size_t i = 0; i < length; i++) {
+    uint8_t c = (uint8_t)text[i];
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+
+    written += out.write((const uint8_t *)text + start, i - start);
+    start = i + 1;
+
+    char escape[6] = {'\\', 0, 0, 0, 0, 0};
+    size_t escapeLength = 2;
+    switch (c) {
+    case '"':
+    case '\\':
+      escape[1] = c;
+      break;
+    case '\n':
+      escape[1] = 'n';
+      break;
+    case '\r':
+      escape[1] = 'r';
+      break;
+    case '\t':
+      escape[1] = 't';
+      break;
+    case '\b':
+      escape[1] = 'b';
+      break;
+    case '\f':
+      escape[1] = 'f';
+      break;
+    default:
+      escape[1] = 'u';
+      escape[2] = '0';
+      escape[3] = '0';
+      escape[4] = HEX_DIGITS[c >> 4];
+      escape[5] = HEX_DIGITS[c & 0x0F];
+      escapeLength = 6;
+      break;
+    }
+    written += out.write((const uint8_t *)escape, escapeLength);
+  }
+  written += out.write((const uint8_t *)text + start, length - start);
+  written += out.write('"');
+  return written;
+}
+
+inline size_t printJsonString(Print &out, const String &text) {
+  return printJsonString(out, text.c_str(), text.length());
+}
+
+inline size_t printJsonString(Print &out, const char *text) {
+  return text ? printJsonString(out, text, strlen(text)) : out.print("null");
+}
+
+/**
+ * @brief Writes a collection key as a JSON object key.
+ * Numeric keys are written as quoted numbers, like ArduinoJson does.
+ *
+ * @param out The sink to write to.
+ * @param key The key to write.
+ * @return The number of bytes written.
+ */
+template <typename T> size_t printJsonKey(Print &out, const T &key) {
+  if constexpr (std::is_arithmetic<T>::value) {
+    size_t written = out.write('"');
+    written += out.print(key);
+    written += out.write('"');
+    return written;
+  } else {
+    return printJsonString(out, key);
+  }
+}
+
+/**
+ * @brief Gets the text a collection key is stored under in a JSON object,
+ * for the helpers that build a JsonDocument or a String of a collection.
+ * Numeric keys become their decimal text, like @ref printJsonKey writes
+ * them, text keys are passed through. Key types that are neither provide
+ * their own overload, like Column does in Columns.h.
+ *
+ * @param key The key to convert.
+ * @return The key as text.
+ */
+template <typename T> decltype(auto) jsonKeyText(const T &key) {
+  if constexpr (std::is_arithmetic<T>::value) {
+    return String(key);
+  } else {
+    return (key);
+  }
+}
+
+/**
+ * @brief Writes a value as JSON.
+ * ArrayLists are written as arrays and maps as objects, nested to any depth.
+ * Strings are escaped, numbers and booleans are written as they are.
+ *
+ * @param out The sink to write to.
+ * @param value The value to write.
+ * @return The number of bytes written.
+ */
+template <typename T> size_t printJsonValue(Print &out, const T &value) {
+  if constexpr (is_arraylist<T>::value) {
+    size_t written = out.write('[');
+    for (size_t i = 0; i < value.size(); i++) {
+      if (i > 0)
+        written += out.write(',');
+      written += printJsonValue(out, value.get(i));
+    }
+    written += out.write(']');
+    return written;
+  } else if constexpr (is_hashmap<T>::value || is_staticmap<T>::value) {
+    size_t written = out.write('{');
+    bool first = true;
+    value.foreach ([&out, &written, &first](const auto &key,
+                                            const auto &item) {
+      if (!first)
+        written += out.write(',');
+      first = false;
+      written += printJsonKey(out, key);
+      written += out.write(':');
+      written += printJsonValue(out, item);
+    });
+    written += out.write('}');
+    return written;
+  } else if constexpr (std::is_same<T, bool>::value) {
+    return out.print(value ? "true" : "false");
+  } else if constexpr (std::is_arithmetic<T>::value) {
+    return out.print(value);
+  } else {
+    return printJsonString(out, value);
+  }
+}
+
+/**
+ * @brief Measures the length of the JSON text of a value.
+ * The text is generated into a CountingPrint, so nothing is allocated.
+ *
+ * @param value The value to measure.
+ * @return The number of bytes @ref printJsonValue writes for the value.
+ */
+template <typename T> size_t measureJsonValue(const T &value) {
+  CountingPrint counter;
+  printJsonValue(counter, value);
+  return counter.length();
+}
+
+/**
+ * @brief Position of a JsonStream in the entries of a collection.
+ * Maps provide their own cursor for @ref foreachFrom, lists are read by
+ * index and don't need one.
+ *
+ * @tparam T The type of the collection.
+ */
+template <typename T, typename = void> struct JsonCursor {
+  using type = size_t;
+  static type start(const T &) { return 0; }
+};
+
+template <typename T>
+struct JsonCursor<T, std::void_t<typename T::Cursor>> {
+  using type = typename T::Cursor;
+  static type start(const T &value) { return value.cursor(); }
+};
+
+/**
+ * @brief A Stream that reads the JSON text of a collection.
+ * The text is never held in memory: it's generated into a small window as
+ * it's read. The window continues from a cursor, the chunk the last window
+ * ended in and the offset within it, where a chunk is a bracket or a single
+ * entry with its leading comma. Chunks before the cursor are never visited
+ * again, so streaming a collection generates its text about once: list
+ * entries are reached by index, and maps resume their walk with
+ * foreachFrom. This lets an HTTP request send a collection as its body,
+ * with a known length, without serializing it into a String first; the
+ * reader still copies it out a window at a time. The collection must not
+ * change while it's being read.
+ *
+ * @tparam T The type of the collection.
+ */
+template <typename T> class JsonStream : public Stream {
+  static_assert(is_arraylist<T>::value || is_hashmap<T>::value ||
+                    is_staticmap<T>::value,
+                "JsonStream reads an ArrayList, a HashMap or a StaticMap");
+
+  private:
+  // Number of bytes generated per window
+  static const size_t WINDOW_SIZE = 64;
+
+  /**
+   * @brief A Print that keeps the bytes of a chunk from an offset on, until
+   * the window is full.
+   */
+  class WindowPrint : public Print {
+    private:
+    uint8_t *window;
+    size_t kept = 0;
+    size_t skip = 0;
+    size_t position = 0;
+
+    public:
+    WindowPrint(uint8_t *window) : window(window) {}
+
+    /**
+     * @brief Starts writing a chunk.
+     *
+     * @param offset The number of bytes of the chunk that were already read.
+     */
+    void startChunk(size_t offset) {
+      skip = offset;
+      position = 0;
+    }
+
+    size_t write(uint8_t c) override {
+      if (position >= skip && kept < WINDOW_SIZE) {
+        window[kept++] = c;
+      }
+      position++;
+      return 1;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override {
+      for (size_t i = 0; i < size; i++) {
+        write(buffer[i]);
+      }
+      return size;
+    }
+
+    size_t chunkLength() const { return position; }
+    size_t length() const { return kept; }
+  };
+
+  const T &value;
+  size_t total;
+  size_t position = 0;
+  // Chunk the next window starts in
+  size_t chunk = 0;
+  // Map entry the next window starts in
+  typename JsonCursor<T>::type entry;
+  // Bytes of that chunk already read
+  size_t chunkOffset = 0;
+  uint8_t window[WINDOW_SIZE];
+  size_t windowStart = 0;
+  size_t windowLength = 0;
+
+  /**
+   * @brief Writes a chunk into the window from the cursor on.
+   * The cursor moves past the bytes that fit the window.
+   *
+   * @param sink The window to write into.
+   * @param write Writes the whole chunk to a Print.
+   * @return True if the chunk was written to its end, false if the window
+   * is full.
+   */
+  template <typename Write> bool writeChunk(WindowPrint &sink, Write write) {
+    size_t kept = sink.length();
+    sink.startChunk(chunkOffset);
+    write(sink);
+
+    chunkOffset += sink.length() - kept;
+    if (chunkOffset < sink.chunkLength())
+      return false;
+
+    chunk++;
+    chunkOffset = 0;
+    return true;
+  }
+
+  /**
+   * @brief Generates the next window at the read position, if needed.
+   */
+  void fill() {
+    if (position < windowStart + windowLength)
+      return;
+
+    constexpr bool isList = is_arraylist<T>::value;
+    const char open = isList ? '[' : '{';
+    const char close = isList ? ']' : '}';
+    size_t entries = value.size();
+    WindowPrint sink(window);
+    bool hasRoom = true;
+
+    if (chunk == 0) {
+      hasRoom = writeChunk(sink, [open](Print &out) { out.write(open); });
+    }
+
+    if constexpr (isList) {
+      while (hasRoom && chunk <= entries) {
+        size_t index = chunk - 1;
+        hasRoom = writeChunk(sink, [this, index](Print &out) {
+          if (index > 0)
+            out.write(',');
+          printJsonValue(out, value.get(index));
+        });
+      }
+    } else if (hasRoom && chunk <= entries) {
+      value.foreachFrom(entry, [this, &sink, &hasRoom](const auto &key,
+                                                       const auto &item) {
+        size_t index = chunk - 1;
+        hasRoom = writeChunk(sink, [index, &key, &item](Print &out) {
+          if (index > 0)
+            out.write(',');
+          printJsonKey(out, key);
+          out.write(':');
+          printJsonValue(out, item);
+        });
+        return hasRoom;
+      });
+    }
+
+    if (hasRoom && chunk == entries + 1) {
+      writeChunk(sink, [close](Print &out) { out.write(close); });
+    }
+
+    windowStart = position;
+    windowLength = sink.length();
+  }
+
+  public:
+  /**
+   * @brief Constructor for the JsonStream.
+   * Measures the JSON text once, so its length is known up front.
+   *
+   * @param value The collection to read as JSON.
+   */
+  JsonStream(const T &value)
+      : value(value), total(measureJsonValue(value)),
+        entry(JsonCursor<T>::start(value)) {}
+
+  /**
+   * @brief Gets the length of the JSON text.
+   *
+   * @return The total number of bytes of the stream.
+   */
+  size_t size() const { return total; }
+
+  int available() override { return total - position; }
+
+  int peek() override {
+    if (position >= total)
+      return -1;
+    fill();
+    return window[position - windowStart];
+  }
+
+  int read() override {
+    int c = peek();
+    if (c >= 0)
+      position++;
+    return c;
+  }
+
+  size_t write(uint8_t) override { return 0; }
+};
+
+#endif
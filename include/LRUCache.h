@@ -0,0 +1,231 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+// Import package for Data Collections
+#include <HashMap.h>
+
+/**
+ * @brief A bounded cache that evicts the least recently used entry.
+ * This class keeps up to a fixed number of key-value pairs in a preallocated
+ * node array linked in recency order, with a HashMap from key to node.
+ * Looking up an entry moves it to the front, and inserting into a full cache
+ * replaces the entry at the back. The cache counts its hits and misses.
+ *
+ * @tparam K The type of the key.
+ * @tparam V The type of the value.
+ */
+template <typename K, typename V> class LRUCache {
+  private:
+  // Marks the end of the recency list and the free list
+  static const size_t NONE = (size_t)-1;
+
+  /**
+   * @brief A single cached entry linked in recency order.
+   */
+  struct Node {
+    K key;
+    V value;
+    size_t prev;
+    size_t next;
+  };
+
+  Node *nodes;
+  HashMap<K, size_t> index;
+  size_t capacity;
+  size_t count;
+  size_t head;     // Most recently used node
+  size_t tail;     // Least recently used node
+  size_t freeHead; // First unused node
+  size_t hits;
+  size_t misses;
+
+  /**
+   * @brief Unlinks a node from the recency list.
+   *
+   * @param node The index of the node to unlink.
+   */
+  void unlink(size_t node) {
+    if (nodes[node].prev != NONE) {
+      nodes[nodes[node].prev].next = nodes[node].next;
+    } else {
+      head = nodes[node].next;
+    }
+    if (nodes[node].next != NONE) {
+      nodes[nodes[node].next].prev = nodes[node].prev;
+    } else {
+      tail = nodes[node].prev;
+    }
+  }
+
+  /**
+   * @brief Links a node at the front of the recency list.
+   *
+   * @param node The index of the node to link.
+   */
+  void pushFront(size_t node) {
+    nodes[node].prev = NONE;
+    nodes[node].next = head;
+    if (head != NONE) {
+      nodes[head].prev = node;
+    }
+    head = node;
+    if (tail == NONE) {
+      tail = node;
+    }
+  }
+
+  public:
+  /**
+   * @brief Constructor for the LRUCache.
+   * Preallocates every node, so the cache doesn't allocate nodes while
+   * it's in use.
+   *
+   * @param capacity The maximum number of cached entries.
+   */
+  LRUCache(size_t capacity = 8)
+      : capacity(capacity > 0 ? capacity : 1), count(0), head(NONE),
+        tail(NONE), freeHead(NONE), hits(0), misses(0) {
+    nodes = new Node[this->capacity];
+    clear();
+  }
+
+  LRUCache(const LRUCache &) = delete;
+  LRUCache &operator=(const LRUCache &) = delete;
+
+  /**
+   * @brief Destructor for the LRUCache.
+   * Frees the node array.
+   */
+  ~LRUCache() { delete[] nodes; }
+
+  /**
+   * @brief Looks up a cached value.
+   * On a hit, the entry becomes the most recently used one.
+   *
+   * @param key The key to search for.
+   * @param value Receives the cached value on a hit.
+   * @return True if the key was cached, false otherwise.
+   */
+  bool get(const K &key, V &value) {
+    const size_t *found = index.find(key);
+    if (found == nullptr) {
+      misses++;
+      return false;
+    }
+
+    size_t node = *found;
+    unlink(node);
+    pushFront(node);
+    value = nodes[node].value;
+    hits++;
+    return true;
+  }
+
+  /**
+   * @brief Checks if a key is cached without touching its recency.
+   *
+   * @param key The key to check for.
+   * @return True if the key is cached, false otherwise.
+   */
+  bool containsKey(const K &key) const { return index.containsKey(key); }
+
+  /**
+   * @brief Inserts or updates a cached value.
+   * The entry becomes the most recently used one. If the cache is full,
+   * the least recently used entry is evicted.
+   *
+   * @param key The key to cache.
+   * @param value The value to cache.
+   */
+  void put(const K &key, const V &value) {
+    size_t node;
+    const size_t *found = index.find(key);
+    if (found != nullptr) {
+      node = *found;
+      unlink(node);
+    } else if (freeHead != NONE) {
+      node = freeHead;
+      freeHead = nodes[node].next;
+      count++;
+    } else {
+      node = tail;
+      unlink(node);
+      index.remove(nodes[node].key);
+    }
+
+    nodes[node].key = key;
+    nodes[node].value = value;
+    index.update(key, node);
+    pushFront(node);
+  }
+
+  /**
+   * @brief Removes a cached entry.
+   *
+   * @param key The key of the entry to remove.
+   * @return True if the entry was removed, false if the key wasn't cached.
+   */
+  bool remove(const K &key) {
+    const size_t *found = index.find(key);
+    if (found == nullptr)
+      return false;
+
+    size_t node = *found;
+    unlink(node);
+    index.remove(key);
+    nodes[node].next = freeHead;
+    freeHead = node;
+    count--;
+    return true;
+  }
+
+  /**
+   * @brief Removes every cached entry.
+   * The hit and miss counters are kept.
+   */
+  void clear() {
+    index.clear();
+    head = tail = NONE;
+    freeHead = NONE;
+    for (size_t i = capacity; i > 0; i--) {
+      nodes[i - 1].next = freeHead;
+      freeHead = i - 1;
+    }
+    count = 0;
+  }
+
+  /**
+   * @brief Gets the number of cached entries.
+   *
+   * @return The number of cached entries.
+   */
+  size_t size() const { return count; }
+
+  /**
+   * @brief Gets the maximum number of cached entries.
+   *
+   * @return The capacity of the cache.
+   */
+  size_t getCapacity() const { return capacity; }
+
+  /**
+   * @brief Gets the number of lookups that found their key.
+   *
+   * @return The number of cache hits.
+   */
+  size_t getHits() const { return hits; }
+
+  /**
+   * @brief Gets the number of lookups that didn't find their key.
+   *
+   * @return The number of cache misses.
+   */
+  size_t getMisses() const { return misses; }
+
+  /**
+   * @brief Resets the hit and miss counters.
+   */
+  void resetStats() { hits = misses = 0; }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MEMBERINDEX_H
+#define MEMBERINDEX_H
+
+#include <Arduino.h>
+
+// Import package for Data Collections
+#include <ArrayList.h>
+#include <HashMap.h>
+
+// Import package for Member Record
+#include <MemberRecord.h>
+
+/**
+ * @brief A single result of a name search.
+ * It holds the roster slot of the matched member and the rank of the match,
+ * where a lower score means a better match.
+ */
+struct NameMatch {
+  size_t slot;
+  uint8_t score;
+};
+
+/**
+ * @brief MemberIndex class for searching the cached member roster.
+ * This class keeps the member roster in RAM together with a sorted array of
+ * normalised names, so members can be resolved by name or card UID without
+ * downloading the member table from the PostmanAPI Server.
+ * Names are normalised to lower case with single spaces, which lets the
+ * operator type names without matching case or spacing exactly.
+ */
+class MemberIndex {
+  private:
+  // Roster of members, indexed by roster slot
+  ArrayList<MemberRecord> members;
+  // Normalised member names, indexed by roster slot
+  ArrayList<String> names;
+  // Roster slots sorted by normalised member name
+  ArrayList<size_t> sortedSlots;
+  // Roster slots indexed by card UID
+  HashMap<String, size_t> uidSlots;
+
+  size_t lowerBound(const String &key) const;
+  size_t upperBound(const String &key) const;
+  size_t append(const MemberRecord &member);
+  uint8_t rankName(const String &query, const String &name) const;
+
+  public:
+  // Default number of suggestions returned by a search
+  static const size_t DEFAULT_SUGGESTIONS = 5;
+
+  static String normalize(const String &text);
+
+  void rebuild(const ArrayList<MemberRecord> &roster);
+  size_t add(const MemberRecord &member);
+  void clear();
+
+  size_t size() const;
+  const MemberRecord &get(size_t slot) const;
+
+  int findByName(const String &name) const;
+  int findByUID(const String &uid) const;
+  ArrayList<NameMatch> searchPrefix(const String &prefix,
+                                    size_t limit = DEFAULT_SUGGESTIONS) const;
+  ArrayList<NameMatch> suggest(const String &query,
+                               size_t limit = DEFAULT_SUGGESTIONS) const;
+};
+
+#endif
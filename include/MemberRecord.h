@@ -0,0 +1,30 @@
+#ifndef MEMBERRECORD_H
+#define MEMBERRECORD_H
+
+#include <Arduino.h>
+
+/**
+ * @brief A single member entry of the cached roster.
+ * This structure holds the member fields that are needed on the device
+ * to resolve a member locally without downloading the member table again.
+ * The display strings are computed once when the record enters a local
+ * cache, so the OLED screens can print them directly.
+ */
+struct MemberRecord {
+  // Member ID in the member table
+  String id;
+  // UID of the member's ID card
+  String uid;
+  // Member NIM
+  String nim;
+  // Member full name
+  String name;
+  // Member division short name
+  String division;
+  // Abbreviated member name ready to be shown on the OLED
+  String displayName;
+
+  void prepareDisplay();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef PARTIALSSD1306_H
+#define PARTIALSSD1306_H
+
+#include <Arduino.h>
+
+// Import package for OLED 128x64
+#include <Adafruit_SSD1306.h>
+#include <Wire.h>
+
+/**
+ * @brief An SSD1306 display that only sends the changed part of the screen.
+ * Adafruit_SSD1306::display() sends the whole framebuffer on every call,
+ * which is 1 KB over I2C for a 128x64 screen, even if a screen change only
+ * adds a dot. This class keeps a copy of the framebuffer as it was last
+ * sent. On @ref display, every page (8 pixel rows) is compared with the
+ * copy, and only the columns between the first and the last changed byte
+ * of each changed page are sent, using the page and column addressing of
+ * the SSD1306. A page that didn't change isn't sent at all.
+ *
+ * Drawing works as before, so a screen can still be cleared and redrawn
+ * in full: the pixels that end up the same aren't sent again.
+ */
+class PartialSSD1306 : public Adafruit_SSD1306 {
+  private:
+  // Framebuffer as it was last sent to the display
+  uint8_t *shadow;
+  // Whether the shadow matches the display RAM
+  bool isShadowValid;
+
+  void sendCommands(const uint8_t *commands, size_t length);
+  void sendRegion(uint8_t page, uint8_t firstColumn, uint8_t lastColumn);
+
+  public:
+  PartialSSD1306(uint8_t width, uint8_t height, TwoWire *twi = &Wire,
+                 int8_t resetPin = -1, uint32_t clkDuring = 400000UL,
+                 uint32_t clkAfter = 100000UL);
+  ~PartialSSD1306();
+
+  PartialSSD1306(const PartialSSD1306 &) = delete;
+  PartialSSD1306 &operator=(const PartialSSD1306 &) = delete;
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+             bool reset = true, bool periphBegin = true);
+  void display();
+  void invalidate();
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+
+/**
+ * @brief A fixed-size queue for handing items from one task to another.
+ * Exactly one task may push and exactly one task may pop, which lets the
+ * queue work without locks: the producer only writes the tail index, the
+ * consumer only writes the head index, and each index is published with
+ * release ordering after the slot it covers. Neither side ever blocks, a
+ * full or empty queue is reported to the caller instead.
+ *
+ * The indices count up forever and are masked into the slot array, so the
+ * capacity must be a power of two. All N slots are usable.
+ *
+ * @tparam T The type of the items, must be default constructible.
+ * @tparam N The number of slots, a power of two.
+ */
+template <typename T, size_t N> class RingBuffer {
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "RingBuffer capacity must be a power of two");
+
+  private:
+  static const size_t MASK = N - 1;
+
+  T items[N];
+  // Position of the next item to pop, written by the consumer only
+  std::atomic<size_t> head;
+  // Position of the next slot to push, written by the producer only
+  std::atomic<size_t> tail;
+
+  public:
+  /**
+   * @brief Constructor for the RingBuffer class.
+   * Creates an empty queue, the slots are default constructed once here.
+   */
+  RingBuffer() : head(0), tail(0) {}
+
+  RingBuffer(const RingBuffer &) = delete;
+  RingBuffer &operator=(const RingBuffer &) = delete;
+
+  /**
+   * @brief Adds an item to the back of the queue.
+   * Must only be called from the producer task.
+   *
+   * @param item The item to add.
+   * @return True if the item was added, false if the queue is full.
+   */
+  bool push(const T &item) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == N)
+      return false;
+
+    items[position & MASK] = item;
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Moves an item to the back of the queue.
+   * Must only be called from the producer task.
+   *
+   * @param item The item to move. Left untouched if the queue is full.
+   * @return True if the item was added, false if the queue is full.
+   */
+  bool push(T &&item) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == N)
+      return false;
+
+    items[position & MASK] = std::move(item);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Takes the item at the front of the queue.
+   * Must only be called from the consumer task.
+   *
+   * @param item Receives the item. Left untouched if the queue is empty.
+   * @return True if an item was taken, false if the queue is empty.
+   */
+  bool pop(T &item) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if (position == tail.load(std::memory_order_acquire))
+      return false;
+
+    item = std::move(items[position & MASK]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Returns the number of items in the queue.
+   * When called from a third task, the result may already be stale.
+   *
+   * @return The number of items waiting to be popped.
+   */
+  size_t size() const {
+    // Head first: the tail read after it can never be behind it
+    size_t first = head.load(std::memory_order_acquire);
+    size_t last = tail.load(std::memory_order_acquire);
+    return last - first < N ? last - first : N;
+  }
+
+  /**
+   * @brief Checks if the queue is empty.
+   *
+   * @return True if there's nothing to pop, false otherwise.
+   */
+  bool isEmpty() const { return size() == 0; }
+
+  /**
+   * @brief Checks if the queue is full.
+   *
+   * @return True if a push would fail, false otherwise.
+   */
+  bool isFull() const { return size() == N; }
+
+  /**
+   * @brief Returns the number of slots of the queue.
+   *
+   * @return The capacity N.
+   */
+  constexpr size_t getCapacity() const { return N; }
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef ROSTERSTORE_H
+#define ROSTERSTORE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+
+// Import package for Member Index (Local)
+#include <MemberIndex.h>
+
+/**
+ * @brief An immutable version of the member roster.
+ * A snapshot is never modified after it has been published, so any number
+ * of tasks can read it at the same time without synchronisation.
+ */
+struct RosterSnapshot {
+  // Indexed members of this roster version
+  MemberIndex index;
+  // Version number, increased by every publish
+  uint32_t version = 0;
+};
+
+class RosterStore;
+
+/**
+ * @brief A read handle of the current roster snapshot.
+ * The snapshot stays valid for as long as the handle exists, even if a newer
+ * snapshot is published in the meantime. Handles should be short-lived,
+ * because the writer reclaims an old snapshot only after every handle of it
+ * has been released.
+ */
+class RosterHandle {
+  private:
+  friend class RosterStore;
+
+  const RosterStore *store;
+  const RosterSnapshot *snapshot;
+  uint8_t parity;
+
+  RosterHandle(const RosterStore *store, const RosterSnapshot *snapshot,
+               uint8_t parity);
+
+  public:
+  RosterHandle(RosterHandle &&other);
+  RosterHandle(const RosterHandle &) = delete;
+  RosterHandle &operator=(const RosterHandle &) = delete;
+  RosterHandle &operator=(RosterHandle &&) = delete;
+  ~RosterHandle();
+
+  const MemberIndex &operator*() const;
+  const MemberIndex *operator->() const;
+  uint32_t version() const;
+};
+
+/**
+ * @brief RosterStore class for sharing the member roster between tasks.
+ * The roster is held as immutable versioned snapshots. A refresh builds the
+ * new snapshot off to the side and publishes it with a single atomic pointer
+ * swap, so readers never take a lock and never wait for a refresh.
+ * Retired snapshots are reclaimed with two reader epochs: after the swap the
+ * writer flips the epoch twice and waits until the readers of the previous
+ * epochs have released their handles.
+ */
+class RosterStore {
+  private:
+  friend class RosterHandle;
+
+  // Snapshot returned to new readers
+  std::atomic<RosterSnapshot *> current;
+  // Reader epoch, flipped by the writer to retire snapshots
+  std::atomic<uint32_t> epoch;
+  // Number of active readers, by epoch parity
+  mutable std::atomic<uint32_t> readers[2];
+  // Serialises writers, readers never take it
+  std::mutex writer;
+
+  void swap(RosterSnapshot *next);
+
+  public:
+  RosterStore();
+  ~RosterStore();
+
+  RosterStore(const RosterStore &) = delete;
+  RosterStore &operator=(const RosterStore &) = delete;
+
+  RosterHandle acquire() const;
+  void publish(const ArrayList<MemberRecord> &roster);
+  void add(const MemberRecord &member);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef SEMAPHOREGUARD_H
+#define SEMAPHOREGUARD_H
+
+// Import package for FreeRTOS semaphores
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * @brief Holds a FreeRTOS mutex until the end of a scope.
+ * The mutex is taken when the guard is created and given back when it's
+ * destroyed, so every way out of the scope releases it.
+ */
+class SemaphoreGuard {
+  private:
+  SemaphoreHandle_t mutex;
+
+  public:
+  /**
+   * @brief Takes the mutex, waiting as long as it's held by another task.
+   *
+   * @param mutex The mutex to hold.
+   */
+  explicit SemaphoreGuard(SemaphoreHandle_t mutex) : mutex(mutex) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+
+  /**
+   * @brief Gives the mutex back.
+   */
+  ~SemaphoreGuard() { xSemaphoreGive(mutex); }
+
+  SemaphoreGuard(const SemaphoreGuard &) = delete;
+  SemaphoreGuard &operator=(const SemaphoreGuard &) = delete;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SMALLARRAYLIST_H
+#define SMALLARRAYLIST_H
+
+// Import array list for the list implementation
+#include <ArrayList.h>
+
+/**
+ * @brief A dynamic array class with room for a few items inside the object.
+ * This class is an ArrayList whose allocator keeps a buffer of N items
+ * inside the object itself, so the items only move to the heap when the
+ * list grows past N. A short-lived list that stays within N items, like the
+ * parts of a split string, doesn't allocate.
+ * Apart from the inline capacity, it is an ArrayList and is recognised as
+ * one by the collection type traits.
+ *
+ * @tparam T The type of the items.
+ * @tparam N The number of items stored inline.
+ * @tparam A The allocator of the item buffer once it outgrows the inline
+ * storage, see Allocator.h.
+ */
+template <typename T, size_t N, typename A = HeapAllocator>
+class SmallArrayList : public ArrayList<T, InlineAllocator<N * sizeof(T), A>> {
+  static_assert(N > 0, "SmallArrayList needs an inline capacity");
+
+  public:
+  /**
+   * @brief Default constructor for the SmallArrayList.
+   * Initializes an empty list whose capacity is the inline buffer.
+   *
+   * @param allocator The allocator of the item buffer once it outgrows the
+   * inline storage.
+   */
+  SmallArrayList(const A &allocator = A())
+      : ArrayList<T, InlineAllocator<N * sizeof(T), A>>(
+            N, InlineAllocator<N * sizeof(T), A>(allocator)) {}
+};
+
+#endif
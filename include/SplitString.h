@@ -0,0 +1,38 @@
+#ifndef SPLITSTRING_H
+#define SPLITSTRING_H
+
+#include <Arduino.h>
+
+// Import package for Small Array List (Local)
+#include <SmallArrayList.h>
+
+// Number of split parts kept without allocating
+#define SPLIT_INLINE_PARTS 4
+
+/**
+ * @brief Split a string by a given delimiter.
+ * This function takes an input string and a delimiter character,
+ * and splits the string into a list of substrings based
+ * on the delimiter. Up to SPLIT_INLINE_PARTS parts are kept inside the list
+ * itself, so splitting a date or a name doesn't allocate a list buffer.
+ *
+ * @param str The input string to be split.
+ * @param delimiter The character used as the delimiter.
+ * @return A list containing the split substrings.
+ */
+inline SmallArrayList<String, SPLIT_INLINE_PARTS>
+splitString(const String &str, char delimiter) {
+  SmallArrayList<String, SPLIT_INLINE_PARTS> result;
+  int start = 0;
+  int end;
+  while ((end = str.indexOf(delimiter, start)) != -1) {
+    result.emplace(str.substring(start, end));
+    start = end + 1;
+  }
+  if (start < (int)str.length()) {
+    result.emplace(str.substring(start));
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef STATICMAP_H
+#define STATICMAP_H
+
+#include <stddef.h>
+
+/**
+ * @brief Represents a single entry in the static map.
+ *
+ * @tparam K The type of the key.
+ * @tparam V The type of the value.
+ */
+template <typename K, typename V> struct StaticEntry {
+  K key;
+  V value;
+};
+
+/**
+ * @brief Compares two keys of a static map.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if both keys are equal, false otherwise.
+ */
+template <typename T> constexpr bool staticKeyEquals(const T &a, const T &b) {
+  return a == b;
+}
+
+/**
+ * @brief Compares two C-string keys of a static map by their characters.
+ * Unlike strcmp, this can be evaluated at compile time.
+ *
+ * @param a The first key.
+ * @param b The second key.
+ * @return True if both keys contain the same characters, false otherwise.
+ */
+constexpr bool staticKeyEquals(const char *a, const char *b) {
+  while (*a != '\0' && *a == *b) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+/**
+ * @brief A fixed map of key-value pairs known at compile time.
+ * This class is an aggregate of N entries, so a map declared `constexpr`
+ * (or `static constexpr` inside a function) is built by the compiler and
+ * placed in flash, and costs no heap or time at runtime:
+ *
+ * @code
+ * static constexpr StaticMap<const char *, const char *, 2> columns = {{
+ *     {"nim", "Member NIM"},
+ *     {"nama", "Member Name"},
+ * }};
+ * @endcode
+ *
+ * Lookups scan the entries in order, which is the fastest option for the
+ * handful of entries these maps hold. @ref foreach visits the entries in
+ * the order they were declared.
+ *
+ * @tparam K The type of the key.
+ * @tparam V The type of the value.
+ * @tparam N The number of entries.
+ */
+template <typename K, typename V, size_t N> struct StaticMap {
+  StaticEntry<K, V> entries[N];
+
+  using key_type = K;
+  using mapped_type = V;
+  using is_staticmap = void;
+  // Position of a walk over the entries, see foreachFrom
+  using Cursor = size_t;
+
+  /**
+   * @brief Finds the value associated with the given key.
+   *
+   * @param key The key to search for.
+   * @return A pointer to the value, or nullptr if not found.
+   */
+  constexpr const V *find(const K &key) const {
+    for (size_t i = 0; i < N; i++) {
+      if (staticKeyEquals(entries[i].key, key)) {
+        return &entries[i].value;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Retrieves the value associated with the given key.
+   * If the key does not exist, it returns a default-constructed value.
+   *
+   * @param key The key to search for.
+   * @return The value associated with the key, or a default value if not found.
+   */
+  constexpr V get(const K &key) const {
+    const V *value = find(key);
+    return value ? *value : V();
+  }
+
+  /**
+   * @brief Retrieves the value associated with the given key, or a default
+   * value if the key does not exist.
+   *
+   * @param key The key to search for.
+   * @param defaultValue The value to return if the key is not found.
+   * @return The value associated with the key, or the default value if not
+   * found.
+   */
+  constexpr V getOrDefault(const K &key, const V &defaultValue) const {
+    const V *value = find(key);
+    return value ? *value : defaultValue;
+  }
+
+  /**
+   * @brief Checks if the static map contains the specified key.
+   *
+   * @param key The key to check for existence.
+   * @return True if the key exists, false otherwise.
+   */
+  constexpr bool containsKey(const K &key) const {
+    return find(key) != nullptr;
+  }
+
+  /**
+   * @brief Gets the key of the entry at the given position.
+   *
+   * @param index The position of the entry, in declaration order.
+   * @return The key of the entry.
+   */
+  constexpr const K &keyAt(size_t index) const { return entries[index].key; }
+
+  /**
+   * @brief Gets the value of the entry at the given position.
+   *
+   * @param index The position of the entry, in declaration order.
+   * @return The value of the entry.
+   */
+  constexpr const V &valueAt(size_t index) const {
+    return entries[index].value;
+  }
+
+  /**
+   * @brief Checks if the static map is empty.
+   *
+   * @return True if the static map has no entries, false otherwise.
+   */
+  constexpr bool isEmpty() const { return N == 0; }
+
+  /**
+   * @brief Returns the number of entries in the static map.
+   *
+   * @return The number of entries in the static map.
+   */
+  constexpr size_t size() const { return N; }
+
+  /**
+   * @brief Iterates over each key-value pair in the static map.
+   *
+   * @param callback The function to call for each key-value pair.
+   */
+  template <typename Callback> void foreach (Callback callback) const {
+    for (size_t i = 0; i < N; i++) {
+      callback(entries[i].key, entries[i].value);
+    }
+  }
+
+  /**
+   * @brief Gets the position of the first entry, to start a walk with
+   * @ref foreachFrom.
+   *
+   * @return The position of the first entry.
+   */
+  constexpr Cursor cursor() const { return 0; }
+
+  /**
+   * @brief Iterates over the key-value pairs from a position on.
+   * The position moves past every entry the callback accepts, so a walk
+   * that stopped can be resumed without visiting the earlier entries again.
+   *
+   * @param cursor The position to start from, left where the walk stopped.
+   * @param callback The function to call for each key-value pair. Returning
+   * false stops the walk at that entry.
+   */
+  template <typename Callback>
+  void foreachFrom(Cursor &cursor, Callback callback) const {
+    while (cursor < N && callback(entries[cursor].key, entries[cursor].value)) {
+      cursor++;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef TAPPIPELINE_H
+#define TAPPIPELINE_H
+
+// Settings of the tap pipeline: the reader task waits on the card source,
+// debounces the cards it reads and queues them for the attendance task.
+// Shared by the firmware and the host load test, so both run the same
+// pipeline.
+
+// Longest time a task waits for a card before checking the menu again
+#define CARD_WAIT_TIMEOUT 250
+
+// Time in which repeated reads of the same card count as a single tap
+#define TAP_DEBOUNCE_WINDOW 3000
+
+// Number of taps that can wait for processing, must be a power of two
+#define TAP_QUEUE_SIZE 16
+
+// Number of cards read from the field in one pass, 1 reads a single card
+#define CARD_INVENTORY_SIZE 8
+
+#endif
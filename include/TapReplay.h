@@ -0,0 +1,106 @@
+#ifndef TAPREPLAY_H
+#define TAPREPLAY_H
+
+#include <Arduino.h>
+
+// Import package for Card Reader
+#include <CardReader.h>
+
+// Longest time the replay source waits before checking its schedule again
+#define REPLAY_POLL_INTERVAL 10
+// Longest line of a replay script, including the terminator
+#define REPLAY_LINE_SIZE 64
+// Number of recent latencies the percentiles are computed from
+#define TAP_LATENCY_SAMPLES 256
+
+/**
+ * @brief A card source that replays taps from a script.
+ * Every line of the script is a tap, written as the time of the tap in
+ * milliseconds since the replay started and the card UID in hex, like
+ * "1500 0A 1B 2C 3D". Blank lines and lines starting with '#' are skipped,
+ * and a line "END" ends the replay. Lines that can't be parsed, including
+ * lines longer than REPLAY_LINE_SIZE, are skipped and counted, see
+ * @ref takeParseFailures.
+ *
+ * The script is read from a Stream while the replay runs, such as a file in
+ * LittleFS, or its lines are passed to @ref schedule as they arrive, such as
+ * over a serial port. When its time has come, a tap is put into the
+ * simulated field and leaves it once it's read, so the reader task reads,
+ * debounces and queues it like a real tap. This lets the attendance
+ * pipeline be load tested without tapping cards.
+ */
+class ReplayCardSource : public SimulatedCardSource {
+  private:
+  /**
+   * @brief A tap of the script that isn't due yet.
+   */
+  struct ScheduledTap {
+    CardUID uid;
+    // Time of the tap since the replay started
+    uint32_t offset;
+  };
+
+  // Guards the schedule, lines are scheduled from other tasks
+  StaticSemaphore_t scheduleLockBuffer;
+  SemaphoreHandle_t scheduleLock;
+  ArrayList<ScheduledTap> pending;
+  // Script read by the replay, or nullptr once it's fully read
+  Stream *script;
+  // Time the current replay started at
+  uint32_t startedAt;
+  bool isStarted;
+  bool isEnded;
+  // Whether the end of the current replay was already reported
+  bool isReported;
+  // Taps put into the field by the current replay
+  uint32_t replayed;
+  // Taps of the current replay read by the reader task
+  uint32_t taken;
+  // Longest delay between the time of a tap and its release
+  uint32_t maxLag;
+  // Lines rejected since the failures were last taken
+  uint32_t parseFailures;
+
+  bool parseLine(const char *line);
+  bool readLine(char *line, size_t size);
+  uint32_t release(uint32_t now);
+
+  public:
+  ReplayCardSource();
+
+  void setScript(Stream &stream);
+  bool schedule(const char *line);
+  bool waitForCard(uint32_t timeoutMs) override;
+  bool readCard(CardUID &uid) override;
+
+  bool takeFinished();
+  uint32_t getReplayed();
+  uint32_t getMaxLag();
+  uint32_t takeParseFailures();
+};
+
+/**
+ * @brief Collects the end-to-end latency of processed taps.
+ * The latency of a tap runs from the moment it's read until the attendance
+ * task has finished it. The last TAP_LATENCY_SAMPLES latencies are kept,
+ * so the percentiles describe the recent load, while the count and the
+ * maximum cover every tap since the last reset.
+ */
+class TapLatencyStats {
+  private:
+  uint32_t samples[TAP_LATENCY_SAMPLES];
+  size_t count;
+  uint32_t maximum;
+
+  public:
+  TapLatencyStats();
+
+  void record(uint32_t latencyMs);
+  void reset();
+
+  size_t getCount() const;
+  uint32_t getMax() const;
+  uint32_t percentile(uint8_t percent) const;
+};
+
+#endif
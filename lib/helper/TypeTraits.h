@@ -44,4 +44,48 @@ template <typename, typename = void> struct is_hashmap : std::false_type {};
 template <typename T>
 struct is_hashmap<T, std::void_t<typename T::is_hashmap>> : std::true_type {};
 
+/**
+ * @brief Type traits to check if a type is a StaticMap.
+ * These traits are used to determine if a type is a compile-time StaticMap,
+ * so functions taking a map can accept it next to a HashMap.
+ *
+ * @note This file is part of the custom data collections library.
+ */
+template <typename, typename = void> struct is_staticmap : std::false_type {};
+
+/**
+ * @brief Specialization for StaticMap types.
+ * This specialization checks if a type has a member type `is_staticmap`
+ * to determine if it is a StaticMap.
+ *
+ * @param T The type to check.
+ * @return std::true_type if T is a StaticMap, otherwise std::false_type.
+ */
+template <typename T>
+struct is_staticmap<T, std::void_t<typename T::is_staticmap>>
+    : std::true_type {};
+
+/**
+ * @brief Type traits to check if an allocator keeps its block inline.
+ * A collection using such an allocator can't hand its buffer over to
+ * another collection while the buffer is the allocator's inline storage.
+ *
+ * @note This file is part of the custom data collections library.
+ */
+template <typename, typename = void>
+struct is_inline_allocator : std::false_type {};
+
+/**
+ * @brief Specialization for inline allocator types.
+ * This specialization checks if a type has a member type
+ * `is_inline_allocator` to determine if it is an inline allocator.
+ *
+ * @param T The type to check.
+ * @return std::true_type if T is an inline allocator, otherwise
+ * std::false_type.
+ */
+template <typename T>
+struct is_inline_allocator<T, std::void_t<typename T::is_inline_allocator>>
+    : std::true_type {};
+
 #endif
\ No newline at end of file
@@ -87,7 +87,7 @@ void PostmanAPI::end() {
  *
  * @return True if the data was created successfully, false otherwise.
  */
-bool PostmanAPI::createData(String gateway, JsonDocument jsonData) {
+bool PostmanAPI::createData(String gateway, const JsonDocument &jsonData) {
   String urlString = url + gateway;
 
   httpClient.begin(client, urlString);
@@ -98,6 +98,44 @@ bool PostmanAPI::createData(String gateway, JsonDocument jsonData) {
   serializeJson(jsonData, serializeString);
   responseCode = httpClient.POST(serializeString);
 
+  return checkCreateResponse();
+}
+
+/**
+ * @brief Creates new data in the Supabase database from a stream.
+ * This method sends a POST request to the specified gateway and reads
+ * the request body from the stream while it's being sent.
+ *
+ * @param gateway The API endpoint for the specific gateway.
+ * @param body The stream of the JSON request body.
+ * @param length The length of the request body in bytes.
+ *
+ * @return True if the data was created successfully, false otherwise.
+ */
+bool PostmanAPI::createFromStream(String gateway, Stream &body,
+                                  size_t length) {
+  String urlString = url + gateway;
+
+  httpClient.begin(client, urlString);
+  httpClient.addHeader("Content-Type", "application/json");
+  httpClient.setTimeout(10000);
+
+  responseCode = httpClient.sendRequest("POST", &body, length);
+
+  return checkCreateResponse();
+}
+
+/**
+ * @brief Processes the response of a create request.
+ * This method reads the response of the POST request that was just sent,
+ * stores the error message if the request failed, or the ID of the created
+ * row if it succeeded, and ends the request.
+ *
+ * @return True if the data was created successfully, false otherwise.
+ */
+bool PostmanAPI::checkCreateResponse() {
+  createdId = "";
+
   if (responseCode > 0) {
     String payload = httpClient.getString();
 
@@ -124,6 +162,16 @@ bool PostmanAPI::createData(String gateway, JsonDocument jsonData) {
         return false;
       }
     }
+
+    // The created row is returned as the data object, or as the only item
+    // of the data array
+    JsonDocument doc;
+    if (deserializeJson(doc, payload) == DeserializationError::Ok) {
+      JsonVariantConst data = doc["data"];
+      JsonVariantConst created = data.is<JsonArrayConst>() ? data[0] : data;
+      if (!created["id"].isNull())
+        createdId = created["id"].as<String>();
+    }
   } else {
     response = HTTPClient::errorToString(responseCode);
     Serial.print("Error on HTTP GET request: (");
@@ -140,19 +188,21 @@ bool PostmanAPI::createData(String gateway, JsonDocument jsonData) {
 
 /**
  * @brief Updates existing data in the Supabase database.
- * This method sends an UPDATE request to the specified gateway
- * with the provided card UID and column data to be updated.
+ * This method sends a PATCH request to the specified gateway
+ * with the provided card UID and streams the columns to be updated
+ * as the JSON request body.
  * It retrieves the member UID associated with the card UID
  * and constructs the URL for the update request.
  *
  * @param gateway The API endpoint for the specific gateway.
  * @param cardUID The unique identifier of the card to be updated.
- * @param columnData The data to be updated, organized by column names.
+ * @param body The stream of the JSON request body.
+ * @param length The length of the request body in bytes.
  *
  * @return True if the data was updated successfully, false otherwise.
  */
-bool PostmanAPI::updateData(String gateway, String cardUID,
-                            HashMap<String, String> columnData) {
+bool PostmanAPI::updateFromStream(String gateway, String cardUID, Stream &body,
+                                  size_t length) {
   String urlString = url + gateway;
 
   String *memberUID = getMemberByUID(gateway, cardUID);
@@ -160,10 +210,12 @@ bool PostmanAPI::updateData(String gateway, String cardUID,
     return false;
 
   urlString = urlString + '/' + *memberUID;
+  delete memberUID;
 
   httpClient.begin(client, urlString);
+  httpClient.addHeader("Content-Type", "application/json");
   httpClient.setTimeout(10000);
-  responseCode = httpClient.sendRequest("UPDATE");
+  responseCode = httpClient.sendRequest("PATCH", &body, length);
 
   if (responseCode > 0) {
     String payload = httpClient.getString();
@@ -264,19 +316,20 @@ bool PostmanAPI::deleteData(String gateway, String key) {
  * This method sends a GET request to the specified gateway
  * with the provided card UID and retrieves the data associated
  * with that card. It processes the response and returns a
- * HashMap containing the relevant data.
+ * map containing the relevant data.
  *
  * @param gateway The API endpoint for the specific gateway.
  * @param cardUID The unique identifier of the card to read data for.
- * @param columnData A HashMap containing column names and their corresponding
- *                   keys in the response data.
+ * @param columns The columns to read from the response data.
+ * @param count The number of columns.
  *
- * @return A HashMap containing the retrieved data, organized by column names.
+ * @return A ColumnMap containing the retrieved data, keyed by column.
  */
-HashMap<String, String>
-PostmanAPI::readData(String gateway, String cardUID,
-                     HashMap<String, String> columnData) {
-  HashMap<String, String> data;
+ColumnMap PostmanAPI::readColumns(String gateway, String cardUID,
+                                  const Column *columns, size_t count) {
+  ColumnMap data;
+  COLLECTION_LABEL(data, "readData");
+  data.reserve(count);
   String urlString = url + gateway;
 
   if (gateway.endsWith("mahasiswa")) {
@@ -341,9 +394,8 @@ PostmanAPI::readData(String gateway, String cardUID,
       JsonObject objCard = objData["kartu"];
       JsonArray objLogs = objCard["logs"];
 
-      columnData.foreach ([&data, &objData, &objCard,
-                           &objLogs](const String &key, const String &value) {
-        String columnName = value;
+      for (size_t i = 0; i < count; i++) {
+        const char *key = columnName(columns[i]);
         String columnValue;
 
         String dataValue = objData[key].as<String>();
@@ -360,8 +412,8 @@ PostmanAPI::readData(String gateway, String cardUID,
           columnValue = logValue;
         }
 
-        data.put(columnName, columnValue);
-      });
+        data.put(columns[i], std::move(columnValue));
+      }
     } else if (gateway.endsWith("event")) {
       JsonDocument filter;
       filter["data"][0]["id"] = true;
@@ -382,19 +434,18 @@ PostmanAPI::readData(String gateway, String cardUID,
 
       JsonObject objData = doc["data"][0];
 
-      columnData.foreach (
-          [&data, &objData](const String &key, const String &value) {
-            String columnName = value;
-            String columnValue;
+      for (size_t i = 0; i < count; i++) {
+        const char *key = columnName(columns[i]);
+        String columnValue;
 
-            String dataValue = objData[key].as<String>();
+        String dataValue = objData[key].as<String>();
 
-            if (dataValue != "null") {
-              columnValue = dataValue;
-            }
+        if (dataValue != "null") {
+          columnValue = dataValue;
+        }
 
-            data.put(columnName, columnValue);
-          });
+        data.put(columns[i], std::move(columnValue));
+      }
     }
 
     httpClient.end();
@@ -638,6 +689,106 @@ String *PostmanAPI::getMemberByName(String gateway, String name) {
   return nullptr;
 }
 
+/**
+ * @brief Retrieves every member in the member table.
+ * This method sends a single GET request to the specified gateway
+ * and collects the fields needed to resolve members on the device,
+ * so the roster can be searched locally afterwards. The response is
+ * deserialized straight from the connection, so the member table is never
+ * held as a String next to the parsed document.
+ *
+ * @param gateway The API endpoint for the specific gateway.
+ * @param members The ArrayList that receives the member records. It is
+ * only changed if the whole member table was read.
+ *
+ * @return True if the member table was read, false if the request or the
+ * deserialization failed.
+ */
+bool PostmanAPI::getMembers(String gateway, ArrayList<MemberRecord> &members) {
+  String urlString = url + gateway;
+
+  // Read the body without chunked transfer, so it can be parsed as it
+  // arrives on the stream
+  httpClient.useHTTP10(true);
+  httpClient.begin(client, urlString);
+  httpClient.setTimeout(10000);
+  responseCode = httpClient.GET();
+
+  if (responseCode > 0) {
+    if (responseCode != HTTP_CODE_OK) {
+      String payload = httpClient.getString();
+      int start = payload.indexOf("<pre>") + 5;
+      int end = payload.indexOf("</pre>");
+
+      JsonDocument doc;
+      DeserializationError deserializeError = deserializeJson(doc, payload);
+      if (start != -1 && end != -1 && end > start) {
+        response = payload.substring(start, end);
+      } else if (deserializeError == DeserializationError::Ok) {
+        response = doc["message"].as<String>();
+      } else {
+        response = payload;
+      }
+
+      Serial.print("Error on HTTP GET request: (");
+      Serial.print(responseCode);
+      Serial.print(") ");
+      Serial.println(response);
+      httpClient.end();
+      httpClient.useHTTP10(false);
+      return false;
+    }
+
+    JsonDocument doc, filter;
+    filter["data"][0]["id"] = true;
+    filter["data"][0]["nim"] = true;
+    filter["data"][0]["nama"] = true;
+    filter["data"][0]["divisi"] = true;
+    filter["data"][0]["kartu"]["uid"] = true;
+
+    DeserializationError deserializeError =
+        deserializeJson(doc, httpClient.getStream(),
+                        DeserializationOption::Filter(filter));
+
+    if (deserializeError) {
+      response = deserializeError.c_str();
+      Serial.print("Deserialize Json failed: ");
+      Serial.println(response);
+      httpClient.end();
+      httpClient.useHTTP10(false);
+      return false;
+    }
+
+    JsonArray dataList = doc["data"];
+    ArrayList<MemberRecord> records(dataList.size());
+    for (JsonObject data : dataList) {
+      MemberRecord member;
+      member.id = data["id"].as<String>();
+      member.uid = data["kartu"]["uid"] | "";
+      member.nim = data["nim"] | "";
+      member.name = data["nama"] | "";
+      member.division = data["divisi"] | "";
+      records.add(std::move(member));
+    }
+    doc.clear();
+
+    members = std::move(records);
+    httpClient.end();
+    httpClient.useHTTP10(false);
+    return true;
+  } else {
+    response = HTTPClient::errorToString(responseCode);
+    Serial.print("Error on HTTP GET request: (");
+    Serial.print(responseCode);
+    Serial.print(") ");
+    Serial.println(response);
+  }
+
+  httpClient.end();
+  httpClient.useHTTP10(false);
+  return false;
+}
+
 /**
  * @brief Retrieves an event's ID by its name.
  * This method sends a GET request to the specified gateway
@@ -736,6 +887,16 @@ String PostmanAPI::getUrl() const { return url; }
  */
 String PostmanAPI::getResponse() const { return response; }
 
+/**
+ * @brief Gets the ID of the row created by the last create request.
+ * This method returns the ID the database assigned to the data that was
+ * created, so it doesn't have to be looked up again.
+ *
+ * @return The ID of the created row, or an empty String if the last create
+ * request failed or its response had no ID.
+ */
+String PostmanAPI::getCreatedId() const { return createdId; }
+
 /**
  * @brief Gets the response code from the last API request.
  * This method returns the HTTP response code that was received from the last
@@ -0,0 +1,107 @@
+#include <Allocator.h>
+
+/**
+ * @brief Constructor for the Arena class.
+ * The buffer is allocated once here and reused by every operation.
+ *
+ * @param capacity The size of the buffer in bytes.
+ */
+Arena::Arena(size_t capacity)
+    : buffer(static_cast<unsigned char *>(HeapAllocator().allocate(capacity))),
+      capacity(capacity), offset(0), peak(0), overflow(nullptr) {}
+
+/**
+ * @brief Destructor for the Arena class.
+ * Frees the overflow blocks and the buffer.
+ */
+Arena::~Arena() {
+  release();
+  free(buffer);
+}
+
+/**
+ * @brief Allocates a block from the arena.
+ * The block is taken from the buffer if it fits, otherwise from the heap.
+ *
+ * @param size The size of the block in bytes.
+ * @throws std::bad_alloc If the heap fallback fails.
+ * @return A pointer to the block.
+ */
+void *Arena::allocate(size_t size) {
+  const size_t align = alignof(max_align_t);
+  size_t start = (offset + align - 1) & ~(align - 1);
+  if (start + size <= capacity) {
+    offset = start + size;
+    if (offset > peak)
+      peak = offset;
+    return buffer + start;
+  }
+
+  Overflow *block = static_cast<Overflow *>(
+      HeapAllocator().allocate(sizeof(Overflow) + size));
+  block->next = overflow;
+  overflow = block;
+  return block + 1;
+}
+
+/**
+ * @brief Frees a single block, which the arena does on release instead.
+ *
+ * @param ptr The block to free.
+ * @param size The size the block was allocated with.
+ */
+void Arena::deallocate(void *ptr, size_t size) {}
+
+/**
+ * @brief Resizes a block, keeping its bytes.
+ * The most recent block of the buffer grows in place if there's room.
+ *
+ * @param ptr The block to resize, or nullptr.
+ * @param oldSize The current size of the block.
+ * @param newSize The new size of the block.
+ * @return A pointer to the resized block.
+ */
+void *Arena::reallocate(void *ptr, size_t oldSize, size_t newSize) {
+  unsigned char *bytes = static_cast<unsigned char *>(ptr);
+  if (bytes != nullptr && bytes + oldSize == buffer + offset &&
+      (size_t)(bytes - buffer) + newSize <= capacity) {
+    offset = (bytes - buffer) + newSize;
+    if (offset > peak)
+      peak = offset;
+    return ptr;
+  }
+
+  void *newPtr = allocate(newSize);
+  if (ptr != nullptr) {
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+  }
+  return newPtr;
+}
+
+/**
+ * @brief Gives back every block of the arena at once.
+ * The buffer is kept for the next operation, the overflow blocks are freed.
+ */
+void Arena::release() {
+  while (overflow != nullptr) {
+    Overflow *next = overflow->next;
+    free(overflow);
+    overflow = next;
+  }
+  offset = 0;
+}
+
+/**
+ * @brief Gets the number of buffer bytes in use.
+ *
+ * @return The number of bytes allocated from the buffer.
+ */
+size_t Arena::getUsed() const { return offset; }
+
+/**
+ * @brief Gets the highest number of buffer bytes used at once.
+ * Useful for sizing the buffer, an arena that overflows is too small.
+ *
+ * @return The peak buffer usage in bytes.
+ */
+size_t Arena::getPeak() const { return peak; }
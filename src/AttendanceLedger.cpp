@@ -0,0 +1,178 @@
+#include <AttendanceLedger.h>
+
+/**
+ * @brief Constructor for the AttendanceLedger class.
+ * The ledger starts empty and isn't persisted until @ref begin is called.
+ */
+AttendanceLedger::AttendanceLedger()
+    : pref(nullptr), entries(nullptr), length(0), capacity(0),
+      isDirty(false) {}
+
+/**
+ * @brief Destructor for the AttendanceLedger class.
+ * Frees the ledger entries.
+ */
+AttendanceLedger::~AttendanceLedger() { delete[] entries; }
+
+/**
+ * @brief Loads the ledger from the Preferences database.
+ * This method restores the event and the check-ins saved by a previous run.
+ *
+ * @param pref The opened Preferences database to persist the ledger to.
+ */
+void AttendanceLedger::begin(Preferences &pref) {
+  this->pref = &pref;
+
+  // Drop the slot bitset of the previous ledger format
+  if (pref.isKey("ledger_bits")) {
+    pref.remove("ledger_bits");
+    pref.remove("ledger_date");
+    pref.remove("ledger_roster");
+  }
+
+  event = pref.getString("ledger_event", "");
+
+  delete[] entries;
+  entries = nullptr;
+  length = pref.getBytesLength("ledger_uids") / LEDGER_ENTRY_SIZE;
+  capacity = length;
+  if (length > 0) {
+    entries = new uint8_t[length * LEDGER_ENTRY_SIZE];
+    pref.getBytes("ledger_uids", entries, length * LEDGER_ENTRY_SIZE);
+  }
+  isDirty = false;
+}
+
+/**
+ * @brief Saves the ledger to the Preferences database.
+ */
+void AttendanceLedger::persist() {
+  if (pref == nullptr)
+    return;
+
+  pref->putString("ledger_event", event);
+  if (length > 0) {
+    pref->putBytes("ledger_uids", entries, length * LEDGER_ENTRY_SIZE);
+  } else {
+    pref->remove("ledger_uids");
+  }
+  isDirty = false;
+}
+
+/**
+ * @brief Packs a card UID into a ledger entry.
+ * The hex digits of the UID are read in pairs and any separator is skipped,
+ * so "A1 B2 C3 D4" and "a1b2c3d4" give the same entry.
+ *
+ * @param uid The card UID as hex text.
+ * @param entry The entry of LEDGER_ENTRY_SIZE bytes to fill.
+ * @return True if the UID was packed, false if it isn't a valid UID.
+ */
+bool AttendanceLedger::pack(const String &uid, uint8_t *entry) {
+  memset(entry, 0, LEDGER_ENTRY_SIZE);
+
+  uint8_t size = 0;
+  bool isHighNibble = true;
+  for (unsigned int i = 0; i < uid.length(); i++) {
+    char c = uid[i];
+    if (!isHexadecimalDigit(c))
+      continue;
+
+    uint8_t nibble = isDigit(c) ? c - '0' : (c | 0x20) - 'a' + 10;
+    if (isHighNibble) {
+      if (size == LEDGER_ENTRY_SIZE - 1)
+        return false;
+      entry[1 + size] = nibble << 4;
+    } else {
+      entry[1 + size++] |= nibble;
+    }
+    isHighNibble = !isHighNibble;
+  }
+
+  entry[0] = size;
+  return size > 0 && isHighNibble;
+}
+
+/**
+ * @brief Checks if a packed UID is in the ledger.
+ *
+ * @param entry The packed UID.
+ * @return True if the UID is in the ledger, false otherwise.
+ */
+bool AttendanceLedger::containsEntry(const uint8_t *entry) const {
+  for (size_t i = 0; i < length; i++) {
+    if (memcmp(entries + i * LEDGER_ENTRY_SIZE, entry, LEDGER_ENTRY_SIZE) == 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Binds the ledger to the current event.
+ * If the event differs from the one the ledger was recorded for, every
+ * check-in is cleared and the empty ledger is persisted at once.
+ *
+ * @param event The name of the current event.
+ */
+void AttendanceLedger::sync(const String &event) {
+  if (this->event.equals(event))
+    return;
+
+  this->event = event;
+  length = 0;
+  persist();
+}
+
+/**
+ * @brief Persists the check-ins recorded since the last flush.
+ * This method is called when the device is idle, so a burst of check-ins
+ * costs a single write to the Preferences database.
+ */
+void AttendanceLedger::flush() {
+  if (isDirty)
+    persist();
+}
+
+/**
+ * @brief Checks if a member has already checked in.
+ *
+ * @param uid The card UID of the member.
+ * @return True if the member has checked in, false otherwise.
+ */
+bool AttendanceLedger::contains(const String &uid) const {
+  uint8_t entry[LEDGER_ENTRY_SIZE];
+  return pack(uid, entry) && containsEntry(entry);
+}
+
+/**
+ * @brief Records the check-in of a member.
+ * The check-in is kept in memory until the next @ref flush.
+ *
+ * @param uid The card UID of the member.
+ */
+void AttendanceLedger::mark(const String &uid) {
+  uint8_t entry[LEDGER_ENTRY_SIZE];
+  if (!pack(uid, entry) || containsEntry(entry))
+    return;
+
+  if (length == capacity) {
+    size_t newCapacity = capacity > 0 ? capacity * 2 : 16;
+    uint8_t *newEntries = new uint8_t[newCapacity * LEDGER_ENTRY_SIZE];
+    if (length > 0)
+      memcpy(newEntries, entries, length * LEDGER_ENTRY_SIZE);
+    delete[] entries;
+    entries = newEntries;
+    capacity = newCapacity;
+  }
+
+  memcpy(entries + length * LEDGER_ENTRY_SIZE, entry, LEDGER_ENTRY_SIZE);
+  length++;
+  isDirty = true;
+}
+
+/**
+ * @brief Counts the members that have checked in.
+ *
+ * @return The number of recorded check-ins.
+ */
+size_t AttendanceLedger::count() const { return length; }
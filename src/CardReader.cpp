@@ -0,0 +1,464 @@
+#include <CardReader.h>
+
+#include <chrono>
+#include <string.h>
+
+/**
+ * @brief Compares two card UIDs.
+ *
+ * @param other The UID to compare with.
+ * @return True if both UIDs have the same bytes, false otherwise.
+ */
+bool CardUID::operator==(const CardUID &other) const {
+  return size == other.size && memcmp(bytes, other.bytes, size) == 0;
+}
+
+/**
+ * @brief Formats the UID the way it's stored in the database.
+ * Every byte is written as two upper case hex digits, separated by spaces.
+ *
+ * @return The UID as a String, like "0A 1B 2C 3D".
+ */
+String CardUID::toString() const {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+  String text;
+  text.reserve(size * 3);
+  for (uint8_t i = 0; i < size; i++) {
+    if (i > 0)
+      text += ' ';
+    text += HEX_DIGITS[bytes[i] >> 4];
+    text += HEX_DIGITS[bytes[i] & 0x0F];
+  }
+  return text;
+}
+
+/**
+ * @brief Constructor for the TapDebouncer class.
+ *
+ * @param windowMs The time in milliseconds in which a repeated read of the
+ * same card is rejected.
+ */
+TapDebouncer::TapDebouncer(uint32_t windowMs) : window(windowMs) {}
+
+/**
+ * @brief Checks if a card read is a new tap.
+ * The window counts from the last accepted tap of the card. A card held in
+ * the field isn't read again at all: it's halted after its read and only
+ * answers a request once it has left the field and entered it again, so
+ * the window covers a card that's lifted and tapped again, or bounces.
+ *
+ * @param uid The UID of the card that was read.
+ * @param now The time of the read in milliseconds.
+ * @return True if the read is a new tap, false if it repeats a recent one.
+ */
+bool TapDebouncer::accept(const CardUID &uid, uint32_t now) {
+  for (size_t i = 0; i < TAP_DEBOUNCE_SLOTS; i++) {
+    if (cards[i].size == 0 || cards[i] != uid)
+      continue;
+
+    if (now - acceptedAt[i] < window)
+      return false;
+    acceptedAt[i] = now;
+    return true;
+  }
+
+  // Remember the card in place of the oldest one
+  cards[next] = uid;
+  acceptedAt[next] = now;
+  next = (next + 1) % TAP_DEBOUNCE_SLOTS;
+  return true;
+}
+
+/**
+ * @brief Changes the debounce window.
+ *
+ * @param windowMs The new window in milliseconds.
+ */
+void TapDebouncer::setWindow(uint32_t windowMs) { window = windowMs; }
+
+/**
+ * @brief Constructor for the SimulatedCardSource class.
+ * Starts with an empty field. The semaphores are allocated inside the
+ * object, so a source can be created before the scheduler runs.
+ */
+SimulatedCardSource::SimulatedCardSource()
+    : lock(xSemaphoreCreateMutexStatic(&lockBuffer)),
+      entered(xSemaphoreCreateBinaryStatic(&enteredBuffer)) {}
+
+/**
+ * @brief Checks if a card in the simulated field would answer a request.
+ * Must be called with the lock held.
+ *
+ * @return True if a card in the field isn't halted, false otherwise.
+ */
+bool SimulatedCardSource::hasIdleCard() const {
+  for (size_t i = 0; i < field.size(); i++) {
+    if (!field.get(i).halted)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Prepares the simulated source, which has nothing to set up.
+ */
+void SimulatedCardSource::begin() {}
+
+/**
+ * @brief Waits until a card that isn't halted is in the field.
+ *
+ * @param timeoutMs The longest time to wait in milliseconds.
+ * @return True if a card would answer a request, false otherwise.
+ */
+bool SimulatedCardSource::waitForCard(uint32_t timeoutMs) {
+  uint32_t started = millis();
+  for (;;) {
+    {
+      SemaphoreGuard guard(lock);
+      if (hasIdleCard())
+        return true;
+    }
+
+    // A card entering the field gives the semaphore, check the field again
+    uint32_t elapsed = millis() - started;
+    if (elapsed >= timeoutMs ||
+        xSemaphoreTake(entered, pdMS_TO_TICKS(timeoutMs - elapsed)) != pdTRUE)
+      return false;
+  }
+}
+
+/**
+ * @brief Selects the first card in the field that isn't halted.
+ * The card is halted, or taken out of the field if it was only tapped.
+ *
+ * @param uid Receives the UID of the card.
+ * @return True if a card was read, false if every card is halted.
+ */
+bool SimulatedCardSource::readCard(CardUID &uid) {
+  SemaphoreGuard guard(lock);
+  for (size_t i = 0; i < field.size(); i++) {
+    FieldCard &card = field.get(i);
+    if (card.halted)
+      continue;
+
+    uid = card.uid;
+    if (card.leavesAfterRead) {
+      field.remove(i);
+    } else {
+      card.halted = true;
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Puts a card into the simulated field, where it stays until
+ * @ref leave. A card that's already in the field keeps its state.
+ * Can be called from any task or thread.
+ *
+ * @param uid The UID of the card.
+ */
+void SimulatedCardSource::enter(const CardUID &uid) {
+  {
+    SemaphoreGuard guard(lock);
+    for (size_t i = 0; i < field.size(); i++) {
+      if (field.get(i).uid == uid)
+        return;
+    }
+    field.add(FieldCard{uid, false, false});
+  }
+  xSemaphoreGive(entered);
+}
+
+/**
+ * @brief Takes a card out of the simulated field.
+ * Once out of the field, the card answers requests again when it enters.
+ *
+ * @param uid The UID of the card.
+ */
+void SimulatedCardSource::leave(const CardUID &uid) {
+  SemaphoreGuard guard(lock);
+  for (size_t i = 0; i < field.size(); i++) {
+    if (field.get(i).uid == uid) {
+      field.remove(i);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Taps a card on the simulated reader.
+ * The card enters the field and leaves it as soon as it's read.
+ *
+ * @param uid The UID of the card.
+ */
+void SimulatedCardSource::tap(const CardUID &uid) {
+  {
+    SemaphoreGuard guard(lock);
+    field.add(FieldCard{uid, false, true});
+  }
+  xSemaphoreGive(entered);
+}
+
+#ifdef ARDUINO
+// Enables the receive interrupt with an active low IRQ pin
+#define MFRC522_IRQ_RX_ACTIVE_LOW 0xA0
+
+/**
+ * @brief Constructor for the MFRC522CardSource class.
+ *
+ * @param reader The reader, initialised with PCD_Init before begin.
+ * @param irqPin The GPIO connected to the IRQ pin of the reader.
+ */
+MFRC522CardSource::MFRC522CardSource(MFRC522 &reader, uint8_t irqPin)
+    : reader(reader), irqPin(irqPin), waiter(nullptr) {}
+
+/**
+ * @brief Notifies the waiting task when the IRQ pin fires.
+ *
+ * @param arg The card source the pin belongs to.
+ */
+void IRAM_ATTR MFRC522CardSource::onIrq(void *arg) {
+  MFRC522CardSource *source = static_cast<MFRC522CardSource *>(arg);
+  TaskHandle_t task = source->waiter;
+  if (task == nullptr)
+    return;
+
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(task, &woken);
+  if (woken == pdTRUE)
+    portYIELD_FROM_ISR();
+}
+
+/**
+ * @brief Clears every pending interrupt flag of the reader.
+ */
+void MFRC522CardSource::clearIrq() {
+  reader.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);
+}
+
+/**
+ * @brief Sends a card request and leaves the reader waiting for an answer.
+ * The reader is idled first, which ends the Transceive of the previous
+ * request, and its FIFO is flushed, so every request starts from the same
+ * state. The receive interrupt fires once a card in the field answers.
+ */
+void MFRC522CardSource::requestCard() {
+  reader.PCD_WriteRegister(MFRC522::CommandReg, MFRC522::PCD_Idle);
+  // Flush the FIFO
+  reader.PCD_WriteRegister(MFRC522::FIFOLevelReg, 0x80);
+  reader.PCD_WriteRegister(MFRC522::FIFODataReg, MFRC522::PICC_CMD_REQA);
+  reader.PCD_WriteRegister(MFRC522::CommandReg, MFRC522::PCD_Transceive);
+  // Start the transmission of a short frame of 7 bits
+  reader.PCD_WriteRegister(MFRC522::BitFramingReg, 0x87);
+}
+
+/**
+ * @brief Enables the receive interrupt and attaches the IRQ pin.
+ */
+void MFRC522CardSource::begin() {
+  pinMode(irqPin, INPUT_PULLUP);
+  reader.PCD_WriteRegister(MFRC522::ComIEnReg, MFRC522_IRQ_RX_ACTIVE_LOW);
+  clearIrq();
+  attachInterruptArg(digitalPinToInterrupt(irqPin), onIrq, this, FALLING);
+}
+
+/**
+ * @brief Sleeps until a card answers a request or the timeout passes.
+ * The request is repeated every CARD_REARM_INTERVAL milliseconds, the task
+ * doesn't run in between.
+ *
+ * @param timeoutMs The longest time to wait in milliseconds.
+ * @return True if a card answered, false if the wait timed out.
+ */
+bool MFRC522CardSource::waitForCard(uint32_t timeoutMs) {
+  waiter = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, 0); // Drop notifications of earlier transfers
+
+  bool detected = false;
+  uint32_t started = millis();
+  while (!detected && millis() - started < timeoutMs) {
+    clearIrq();
+    requestCard();
+
+    uint32_t remaining = timeoutMs - (millis() - started);
+    uint32_t wait =
+        remaining < CARD_REARM_INTERVAL ? remaining : CARD_REARM_INTERVAL;
+    detected = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait)) > 0;
+  }
+
+  waiter = nullptr;
+  return detected;
+}
+
+/**
+ * @brief Authenticates the sector of a data block with its key A.
+ * Only MIFARE Classic cards have sectors, other cards are rejected.
+ *
+ * @param block The block to access.
+ * @return True if the block can be read and written, false otherwise.
+ */
+bool MFRC522CardSource::authenticate(uint8_t block) {
+  MFRC522::PICC_Type type = reader.PICC_GetType(reader.uid.sak);
+  if (type != MFRC522::PICC_TYPE_MIFARE_MINI &&
+      type != MFRC522::PICC_TYPE_MIFARE_1K &&
+      type != MFRC522::PICC_TYPE_MIFARE_4K)
+    return false;
+
+  MFRC522::MIFARE_Key key = {CARD_SECTOR_KEY};
+  return reader.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key,
+                                 &reader.uid) == MFRC522::STATUS_OK;
+}
+
+/**
+ * @brief Checks if a card refused the key of the record sector before.
+ *
+ * @param uid The UID of the card.
+ * @return True if the card is read without its record, false otherwise.
+ */
+bool MFRC522CardSource::isLocked(const CardUID &uid) const {
+  for (size_t i = 0; i < CARD_LOCKED_SLOTS; i++) {
+    if (lockedCards[i].size > 0 && lockedCards[i] == uid)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Remembers or forgets that a card refuses the key of the record
+ * sector. A new card takes the place of the oldest one.
+ *
+ * @param uid The UID of the card.
+ * @param isLocked Whether the card refused the key.
+ */
+void MFRC522CardSource::setLocked(const CardUID &uid, bool isLocked) {
+  for (size_t i = 0; i < CARD_LOCKED_SLOTS; i++) {
+    if (lockedCards[i].size == 0 || lockedCards[i] != uid)
+      continue;
+
+    if (!isLocked)
+      lockedCards[i] = CardUID();
+    return;
+  }
+
+  if (isLocked) {
+    lockedCards[nextLocked] = uid;
+    nextLocked = (nextLocked + 1) % CARD_LOCKED_SLOTS;
+  }
+}
+
+/**
+ * @brief Selects a card by anticollision, reads its UID and halts it.
+ * If a record block is set, the block is read before the card is halted.
+ * A card that refuses the key drops back to idle instead, it's remembered
+ * and read without its record from then on, so the next selection halts it.
+ *
+ * @param card Receives the UID and the record block of the card.
+ * @param requested Whether a card already answered a request, so it can
+ * be selected without sending another one.
+ * @return True if a card was read, false otherwise.
+ */
+bool MFRC522CardSource::selectCard(TapEvent &card, bool requested) {
+  bool selected = requested && reader.PICC_ReadCardSerial();
+  if (!selected) {
+    selected = reader.PICC_IsNewCardPresent() && reader.PICC_ReadCardSerial();
+  }
+  if (!selected)
+    return false;
+
+  card.uid.size = reader.uid.size;
+  memcpy(card.uid.bytes, reader.uid.uidByte, card.uid.size);
+
+  card.hasRecord = false;
+  if (recordBlock >= 0 && !isLocked(card.uid)) {
+    if (authenticate(recordBlock)) {
+      byte buffer[CARD_BLOCK_SIZE + 2]; // Room for the CRC of the block
+      byte size = sizeof(buffer);
+      if (reader.MIFARE_Read(recordBlock, buffer, &size) ==
+          MFRC522::STATUS_OK) {
+        memcpy(card.record, buffer, CARD_BLOCK_SIZE);
+        card.hasRecord = true;
+      }
+    } else {
+      setLocked(card.uid, true);
+    }
+  }
+
+  // Stop reading the card, a halted card doesn't answer the next request
+  reader.PICC_HaltA();
+  reader.PCD_StopCrypto1();
+  return true;
+}
+
+/**
+ * @brief Selects the card that answered, reads its UID and halts it.
+ * The card already answered the request, so it's selected directly. If it
+ * dropped back to idle in the meantime, it's requested again first.
+ *
+ * @param uid Receives the UID of the card.
+ * @return True if a card was read, false otherwise.
+ */
+bool MFRC522CardSource::readCard(CardUID &uid) {
+  TapEvent card;
+  clearIrq();
+  bool isRead = selectCard(card, true);
+  clearIrq();
+  if (isRead)
+    uid = card.uid;
+  return isRead;
+}
+
+/**
+ * @brief Reads every card in the field in one pass.
+ * The first card answered the request of @ref waitForCard. Every later
+ * card is found with a new request, which only the cards that haven't been
+ * halted yet answer.
+ *
+ * @param cards Receives the UIDs and record blocks of the cards.
+ * @param max The number of cards the array can hold.
+ * @return The number of cards read.
+ */
+size_t MFRC522CardSource::readCards(TapEvent *cards, size_t max) {
+  clearIrq();
+  size_t count = 0;
+  while (count < max && selectCard(cards[count], count == 0)) {
+    // A card that just refused the key is idle, not halted, so it answers
+    // the next request again. It's halted by that second selection, which
+    // ends the pass
+    bool isRepeated = false;
+    for (size_t i = 0; i < count && !isRepeated; i++) {
+      isRepeated = cards[i].uid == cards[count].uid;
+    }
+    if (isRepeated)
+      break;
+    count++;
+  }
+  clearIrq();
+  return count;
+}
+
+/**
+ * @brief Writes a data block of the card that's currently selected.
+ * Must be called before the card is halted, such as while registering it.
+ *
+ * @param block The block to write, never a sector trailer.
+ * @param data The CARD_BLOCK_SIZE bytes to write.
+ * @return True if the block was written, false otherwise.
+ */
+bool MFRC522CardSource::writeBlock(uint8_t block, const uint8_t *data) {
+  bool isWritten = authenticate(block) &&
+                   reader.MIFARE_Write(block, const_cast<byte *>(data),
+                                       CARD_BLOCK_SIZE) == MFRC522::STATUS_OK;
+
+  // The card accepts the key, so its record can be read again
+  if (isWritten) {
+    CardUID uid;
+    uid.size = reader.uid.size;
+    memcpy(uid.bytes, reader.uid.uidByte, uid.size);
+    setLocked(uid, false);
+  }
+  return isWritten;
+}
+#endif
@@ -0,0 +1,227 @@
+#include <CardRecord.h>
+
+#include <esp_system.h>
+#include <mbedtls/md.h>
+#include <string.h>
+
+// Divisions a record can hold, in the order of the register menu
+static const char *const CARD_DIVISIONS[] = {"RISTEK", "KEOR", "HUBPUB",
+                                             "BPHI"};
+static const size_t CARD_DIVISION_COUNT =
+    sizeof(CARD_DIVISIONS) / sizeof(CARD_DIVISIONS[0]);
+
+// Offsets of the record fields in the block
+static const size_t FIELD_VERSION = 0;
+static const size_t FIELD_DIVISION = 1;
+static const size_t FIELD_MEMBER_ID = 2;
+static const size_t FIELD_NIM = 6;
+static const size_t FIELD_TAG = 12;
+
+/**
+ * @brief Fills the record from a member of the roster.
+ * Only members whose ID and NIM are numbers that fit the record, and
+ * whose division is known, can be stored on a card.
+ *
+ * @param member The member to store on the card.
+ * @return True if the member fits a record, false otherwise.
+ */
+bool CardRecord::assign(const MemberRecord &member) {
+  const char *id = member.id.c_str();
+  size_t idLength = strlen(id);
+  if (idLength == 0 || idLength > 10)
+    return false;
+
+  uint64_t parsedId = 0;
+  for (size_t i = 0; i < idLength; i++) {
+    if (!isDigit(id[i]))
+      return false;
+    parsedId = parsedId * 10 + (id[i] - '0');
+  }
+  if (parsedId > UINT32_MAX)
+    return false;
+
+  size_t nimLength = member.nim.length();
+  if (nimLength == 0 || nimLength > CARD_RECORD_NIM_DIGITS)
+    return false;
+  for (size_t i = 0; i < nimLength; i++) {
+    if (!isDigit(member.nim[i]))
+      return false;
+  }
+
+  for (size_t i = 0; i < CARD_DIVISION_COUNT; i++) {
+    if (member.division.equalsIgnoreCase(CARD_DIVISIONS[i])) {
+      memberId = (uint32_t)parsedId;
+      division = i;
+      memcpy(nim, member.nim.c_str(), nimLength + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Gets the short name of the member division.
+ *
+ * @return The division name, like "RISTEK".
+ */
+const char *CardRecord::divisionName() const {
+  return division < CARD_DIVISION_COUNT ? CARD_DIVISIONS[division] : "";
+}
+
+/**
+ * @brief Constructor for the CardSigner class.
+ * The signer can't encode or verify records until it has a key.
+ */
+CardSigner::CardSigner() : hasKey(false) { memset(key, 0, sizeof(key)); }
+
+/**
+ * @brief Destructor for the CardSigner class.
+ * Wipes the key from memory.
+ */
+CardSigner::~CardSigner() { memset(key, 0, sizeof(key)); }
+
+/**
+ * @brief Loads the key from the Preferences database.
+ * If the key doesn't exist yet, a new key is generated and saved.
+ *
+ * @param pref The Preferences database the key is kept in.
+ */
+void CardSigner::begin(Preferences &pref) {
+  if (pref.getBytesLength("card_key") == sizeof(key)) {
+    pref.getBytes("card_key", key, sizeof(key));
+  } else {
+    esp_fill_random(key, sizeof(key));
+    pref.putBytes("card_key", key, sizeof(key));
+  }
+  hasKey = true;
+}
+
+/**
+ * @brief Sets the key, such as a key shared by several kiosks.
+ * Keys longer than CARD_RECORD_KEY_SIZE are truncated.
+ *
+ * @param secret The key bytes.
+ * @param length The length of the key in bytes.
+ */
+void CardSigner::setKey(const uint8_t *secret, size_t length) {
+  memset(key, 0, sizeof(key));
+  memcpy(key, secret, length < sizeof(key) ? length : sizeof(key));
+  hasKey = true;
+}
+
+/**
+ * @brief Checks if the signer has a key.
+ *
+ * @return True if records can be encoded and verified, false otherwise.
+ */
+bool CardSigner::isReady() const { return hasKey; }
+
+/**
+ * @brief Computes the truncated tag of a record.
+ *
+ * @param uid The UID of the card the record belongs to.
+ * @param block The record block, only the bytes before the tag are used.
+ * @param tag Receives CARD_RECORD_TAG_SIZE bytes of the tag.
+ * @return True if the tag was computed, false otherwise.
+ */
+bool CardSigner::sign(const CardUID &uid, const uint8_t *block,
+                      uint8_t *tag) const {
+  const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  uint8_t digest[32];
+
+  mbedtls_md_context_t context;
+  mbedtls_md_init(&context);
+  bool isSigned = mbedtls_md_setup(&context, info, 1) == 0 &&
+                  mbedtls_md_hmac_starts(&context, key, sizeof(key)) == 0 &&
+                  mbedtls_md_hmac_update(&context, uid.bytes, uid.size) == 0 &&
+                  mbedtls_md_hmac_update(&context, block, FIELD_TAG) == 0 &&
+                  mbedtls_md_hmac_finish(&context, digest) == 0;
+  mbedtls_md_free(&context);
+
+  if (isSigned)
+    memcpy(tag, digest, CARD_RECORD_TAG_SIZE);
+  return isSigned;
+}
+
+/**
+ * @brief Encodes and signs a record for the given card.
+ *
+ * @param record The record to encode.
+ * @param uid The UID of the card the record is written to.
+ * @param block Receives the 16 byte block.
+ * @return True if the block was encoded, false if the signer has no key.
+ */
+bool CardSigner::encode(const CardRecord &record, const CardUID &uid,
+                        uint8_t *block) const {
+  if (!hasKey)
+    return false;
+
+  block[FIELD_VERSION] = CARD_RECORD_VERSION;
+  block[FIELD_DIVISION] = record.division;
+  for (size_t i = 0; i < 4; i++) {
+    block[FIELD_MEMBER_ID + i] = record.memberId >> (24 - 8 * i);
+  }
+
+  // Two digits per byte, the high nibble first, padded with 0xF
+  memset(block + FIELD_NIM, 0xFF, FIELD_TAG - FIELD_NIM);
+  for (size_t i = 0; record.nim[i] != '\0'; i++) {
+    uint8_t digit = record.nim[i] - '0';
+    uint8_t &pair = block[FIELD_NIM + i / 2];
+    pair = i % 2 == 0 ? (digit << 4) | 0x0F : (pair & 0xF0) | digit;
+  }
+
+  return sign(uid, block, block + FIELD_TAG);
+}
+
+/**
+ * @brief Verifies and decodes a record read from a card.
+ * The record is only accepted if its tag matches the card it was read
+ * from, so a forged record or a record copied from another card is
+ * rejected.
+ *
+ * @param block The 16 byte block read from the card.
+ * @param uid The UID of the card the block was read from.
+ * @param record Receives the decoded record.
+ * @return True if the record is valid, false otherwise.
+ */
+bool CardSigner::decode(const uint8_t *block, const CardUID &uid,
+                        CardRecord &record) const {
+  if (!hasKey || block[FIELD_VERSION] != CARD_RECORD_VERSION ||
+      block[FIELD_DIVISION] >= CARD_DIVISION_COUNT)
+    return false;
+
+  uint8_t tag[CARD_RECORD_TAG_SIZE];
+  if (!sign(uid, block, tag))
+    return false;
+
+  // Compare every byte, so the time taken doesn't tell which byte differs
+  uint8_t difference = 0;
+  for (size_t i = 0; i < CARD_RECORD_TAG_SIZE; i++) {
+    difference |= tag[i] ^ block[FIELD_TAG + i];
+  }
+  if (difference != 0)
+    return false;
+
+  char nim[CARD_RECORD_NIM_DIGITS + 1];
+  size_t length = 0;
+  for (; length < CARD_RECORD_NIM_DIGITS; length++) {
+    uint8_t pair = block[FIELD_NIM + length / 2];
+    uint8_t digit = length % 2 == 0 ? pair >> 4 : pair & 0x0F;
+    if (digit == 0x0F)
+      break;
+    if (digit > 9)
+      return false;
+    nim[length] = '0' + digit;
+  }
+  if (length == 0)
+    return false;
+  nim[length] = '\0';
+
+  record.memberId = 0;
+  for (size_t i = 0; i < 4; i++) {
+    record.memberId = (record.memberId << 8) | block[FIELD_MEMBER_ID + i];
+  }
+  record.division = block[FIELD_DIVISION];
+  memcpy(record.nim, nim, length + 1);
+  return true;
+}
@@ -0,0 +1,256 @@
+#include <CollectionStats.h>
+
+#ifdef ENABLE_COLLECTION_STATS
+
+#include <mutex>
+#include <string.h>
+
+// Number of labels whose destroyed instances are totalled
+#define RETIRED_LABELS 16
+
+/**
+ * @brief Totals of the destroyed instances of a label.
+ */
+struct RetiredTotals {
+  const char *label;
+  uint32_t instances;
+  CollectionCounters counters;
+};
+
+/**
+ * @brief Registry of the live instances and the retired totals.
+ */
+struct StatsRegistry {
+  std::mutex lock;
+  CollectionStats *head = nullptr;
+  RetiredTotals retired[RETIRED_LABELS] = {};
+  // Instances whose label didn't fit in the retired table
+  RetiredTotals overflow = {"(other)", 0, {}};
+};
+
+/**
+ * @brief Gets the registry, creating it on first use.
+ * Collections declared as globals register themselves during static
+ * initialisation, so the registry can't be a global itself.
+ *
+ * @return The stats registry.
+ */
+static StatsRegistry &registry() {
+  static StatsRegistry instance;
+  return instance;
+}
+
+/**
+ * @brief Prints the counters of one registry line.
+ *
+ * @param out The sink to print to.
+ * @param state Whether the line is for a live or a retired instance.
+ * @param label The label of the line.
+ * @param instances The number of instances the counters cover.
+ * @param counters The counters to print.
+ */
+static void printCounters(Print &out, const char *state, const char *label,
+                          uint32_t instances,
+                          const CollectionCounters &counters) {
+  out.printf("%-7s %-20s x%-3u %5u allocs %7u B peak %-5u %4u resizes",
+             state, label, instances, counters.allocations, counters.bytes,
+             counters.peakCapacity, counters.resizes);
+  if (counters.lookups > 0) {
+    out.printf(" %u.%02u probes/lookup (max %u)",
+               counters.probes / counters.lookups,
+               counters.probes * 100 / counters.lookups % 100,
+               counters.maxProbe);
+  }
+  out.println();
+}
+
+/**
+ * @brief Adds the counters of another collection to these counters.
+ * Peak values are combined by their maximum.
+ *
+ * @param other The counters to add.
+ */
+void CollectionCounters::merge(const CollectionCounters &other) {
+  allocations += other.allocations;
+  bytes += other.bytes;
+  resizes += other.resizes;
+  lookups += other.lookups;
+  probes += other.probes;
+  if (other.peakCapacity > peakCapacity)
+    peakCapacity = other.peakCapacity;
+  if (other.maxProbe > maxProbe)
+    maxProbe = other.maxProbe;
+}
+
+/**
+ * @brief Constructor for the CollectionStats class.
+ * Registers the instance in the registry.
+ *
+ * @param label The label of the instance, usually its collection type.
+ */
+CollectionStats::CollectionStats(const char *label) : label(label) { link(); }
+
+/**
+ * @brief Copy constructor for the CollectionStats class.
+ * A copied collection is a new instance: it keeps the label, but starts
+ * with its own empty counters.
+ *
+ * @param other The stats to take the label from.
+ */
+CollectionStats::CollectionStats(const CollectionStats &other)
+    : label(other.label) {
+  link();
+}
+
+/**
+ * @brief Assignment operator for the CollectionStats class.
+ * Counters belong to an instance, so assigning a collection keeps them,
+ * and nothing is taken from the other stats.
+ *
+ * @return A reference to these stats.
+ */
+CollectionStats &CollectionStats::operator=(const CollectionStats &) {
+  return *this;
+}
+
+/**
+ * @brief Destructor for the CollectionStats class.
+ * Adds the counters to the retired totals of the label and unregisters
+ * the instance.
+ */
+CollectionStats::~CollectionStats() {
+  StatsRegistry &stats = registry();
+  std::lock_guard<std::mutex> guard(stats.lock);
+
+  RetiredTotals *totals = &stats.overflow;
+  for (size_t i = 0; i < RETIRED_LABELS; i++) {
+    RetiredTotals &slot = stats.retired[i];
+    if (slot.label == nullptr) {
+      slot.label = label;
+      totals = &slot;
+      break;
+    }
+    if (strcmp(slot.label, label) == 0) {
+      totals = &slot;
+      break;
+    }
+  }
+  totals->instances++;
+  totals->counters.merge(counters);
+
+  unlink();
+}
+
+/**
+ * @brief Adds the instance to the live list. Takes the registry lock.
+ */
+void CollectionStats::link() {
+  StatsRegistry &stats = registry();
+  std::lock_guard<std::mutex> guard(stats.lock);
+
+  prev = nullptr;
+  next = stats.head;
+  if (stats.head != nullptr)
+    stats.head->prev = this;
+  stats.head = this;
+}
+
+/**
+ * @brief Removes the instance from the live list.
+ * Must be called with the registry lock held.
+ */
+void CollectionStats::unlink() {
+  StatsRegistry &stats = registry();
+  if (prev != nullptr) {
+    prev->next = next;
+  } else {
+    stats.head = next;
+  }
+  if (next != nullptr)
+    next->prev = prev;
+}
+
+/**
+ * @brief Names the instance in the report.
+ *
+ * @param label The name of the instance, must outlive the instance.
+ */
+void CollectionStats::setLabel(const char *label) { this->label = label; }
+
+/**
+ * @brief Returns the name of the instance in the report.
+ *
+ * @return The label of the instance.
+ */
+const char *CollectionStats::getLabel() const { return label; }
+
+/**
+ * @brief Records a block taken from the allocator.
+ *
+ * @param bytes The size of the block in bytes.
+ */
+void CollectionStats::recordAllocation(size_t bytes) {
+  counters.allocations++;
+  counters.bytes += bytes;
+}
+
+/**
+ * @brief Records the current capacity, keeping the highest one.
+ *
+ * @param capacity The capacity in items or buckets.
+ */
+void CollectionStats::recordCapacity(size_t capacity) {
+  if (capacity > counters.peakCapacity)
+    counters.peakCapacity = capacity;
+}
+
+/**
+ * @brief Records a reallocation or rehash of the storage.
+ *
+ * @param capacity The capacity after the resize.
+ */
+void CollectionStats::recordResize(size_t capacity) {
+  counters.resizes++;
+  recordCapacity(capacity);
+}
+
+/**
+ * @brief Records a key lookup.
+ *
+ * @param probes The number of entries the lookup compared.
+ */
+void CollectionStats::recordLookup(size_t probes) {
+  counters.lookups++;
+  counters.probes += probes;
+  if (probes > counters.maxProbe)
+    counters.maxProbe = probes;
+}
+
+/**
+ * @brief Prints the counters of every collection.
+ * Live instances are printed one per line, destroyed instances are printed
+ * as totals per label.
+ *
+ * @param out The sink to print to, such as Serial.
+ */
+void CollectionStats::dump(Print &out) {
+  StatsRegistry &stats = registry();
+  std::lock_guard<std::mutex> guard(stats.lock);
+
+  out.println("=========] Collection Stats [=========");
+  for (CollectionStats *current = stats.head; current != nullptr;
+       current = current->next) {
+    printCounters(out, "live", current->label, 1, current->counters);
+  }
+  for (size_t i = 0; i < RETIRED_LABELS && stats.retired[i].label; i++) {
+    const RetiredTotals &totals = stats.retired[i];
+    printCounters(out, "retired", totals.label, totals.instances,
+                  totals.counters);
+  }
+  if (stats.overflow.instances > 0) {
+    printCounters(out, "retired", stats.overflow.label,
+                  stats.overflow.instances, stats.overflow.counters);
+  }
+}
+
+#endif
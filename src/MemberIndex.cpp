@@ -0,0 +1,349 @@
+#include <MemberIndex.h>
+
+#include <algorithm>
+
+// Longest text compared by the fuzzy matcher, longer text is truncated
+static const size_t MAX_FUZZY_LENGTH = 32;
+// Rank returned for names that don't match the query at all
+static const uint8_t NO_MATCH = 0xFF;
+
+/**
+ * @brief Computes the edit distance between two character ranges.
+ * This function computes the Levenshtein distance using two rows on the
+ * stack, so it doesn't allocate any memory. Both ranges are truncated to
+ * MAX_FUZZY_LENGTH characters.
+ *
+ * @param a The first character range.
+ * @param aLength The length of the first character range.
+ * @param b The second character range.
+ * @param bLength The length of the second character range.
+ * @return The number of edits needed to turn the first range into the second.
+ */
+static uint8_t editDistance(const char *a, size_t aLength, const char *b,
+                            size_t bLength) {
+  if (aLength > MAX_FUZZY_LENGTH)
+    aLength = MAX_FUZZY_LENGTH;
+  if (bLength > MAX_FUZZY_LENGTH)
+    bLength = MAX_FUZZY_LENGTH;
+
+  uint8_t previous[MAX_FUZZY_LENGTH + 1];
+  uint8_t current[MAX_FUZZY_LENGTH + 1];
+  for (size_t j = 0; j <= bLength; j++) {
+    previous[j] = j;
+  }
+
+  for (size_t i = 1; i <= aLength; i++) {
+    current[0] = i;
+    for (size_t j = 1; j <= bLength; j++) {
+      uint8_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+      uint8_t best = previous[j - 1] + cost;
+      if (previous[j] + 1 < best)
+        best = previous[j] + 1;
+      if (current[j - 1] + 1 < best)
+        best = current[j - 1] + 1;
+      current[j] = best;
+    }
+    memcpy(previous, current, bLength + 1);
+  }
+  return previous[bLength];
+}
+
+/**
+ * @brief Normalises a text for name comparison.
+ * This method converts the text to lower case, removes leading and trailing
+ * whitespace, and collapses every run of whitespace into a single space.
+ *
+ * @param text The text to normalise.
+ * @return The normalised text.
+ */
+String MemberIndex::normalize(const String &text) {
+  String result;
+  result.reserve(text.length());
+
+  bool pendingSpace = false;
+  for (unsigned int i = 0; i < text.length(); i++) {
+    char c = text[i];
+    if (isspace((unsigned char)c)) {
+      pendingSpace = result.length() > 0;
+      continue;
+    }
+    if (pendingSpace) {
+      result += ' ';
+      pendingSpace = false;
+    }
+    result += (char)tolower((unsigned char)c);
+  }
+  return result;
+}
+
+/**
+ * @brief Finds the first position in the sorted names not less than a key.
+ * This method runs a binary search over the roster slots sorted by name.
+ *
+ * @param key The normalised key to search for.
+ * @return The position in the sorted slots of the first name not less than
+ * the key.
+ */
+size_t MemberIndex::lowerBound(const String &key) const {
+  size_t low = 0;
+  size_t high = sortedSlots.size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (strcmp(names.get(sortedSlots.get(mid)).c_str(), key.c_str()) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Finds the first position in the sorted names greater than a key.
+ * Inserting there keeps members with equal names in roster order.
+ *
+ * @param key The normalised key to search for.
+ * @return The position in the sorted slots of the first name greater than
+ * the key.
+ */
+size_t MemberIndex::upperBound(const String &key) const {
+  size_t low = 0;
+  size_t high = sortedSlots.size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (strcmp(names.get(sortedSlots.get(mid)).c_str(), key.c_str()) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Ranks how well a name matches a query.
+ * Exact matches rank first, followed by prefix matches of the full name,
+ * prefix matches of any word of the name, and finally names that are within
+ * a small edit distance of the query.
+ *
+ * @param query The normalised query.
+ * @param name The normalised member name.
+ * @return The rank of the match, or NO_MATCH if the name doesn't match.
+ */
+uint8_t MemberIndex::rankName(const String &query, const String &name) const {
+  if (name.equals(query))
+    return 0;
+  if (name.startsWith(query))
+    return 1;
+
+  const char *text = name.c_str();
+  size_t queryLength = query.length();
+  size_t nameLength = name.length();
+  // Short queries only match by prefix, fuzzy matches would be noise
+  uint8_t maxDistance = queryLength < 3 ? 0 : queryLength / 4 + 1;
+  uint8_t bestDistance = NO_MATCH;
+
+  for (size_t start = 0; start < nameLength; start++) {
+    if (start > 0 && text[start - 1] != ' ')
+      continue;
+
+    size_t remaining = nameLength - start;
+    if (remaining >= queryLength &&
+        strncmp(text + start, query.c_str(), queryLength) == 0)
+      return 2;
+
+    size_t length = remaining < queryLength ? remaining : queryLength;
+    uint8_t distance =
+        editDistance(query.c_str(), queryLength, text + start, length);
+    if (distance < bestDistance)
+      bestDistance = distance;
+  }
+
+  if (bestDistance > maxDistance)
+    return NO_MATCH;
+  return 3 + bestDistance;
+}
+
+/**
+ * @brief Rebuilds the index from a member roster.
+ * This method replaces the current roster with the given one and rebuilds
+ * the card UID lookup. The names are sorted once after every member is
+ * appended, instead of being inserted one by one.
+ *
+ * @param roster The members to index.
+ */
+void MemberIndex::rebuild(const ArrayList<MemberRecord> &roster) {
+  clear();
+  members.reserve(roster.size());
+  names.reserve(roster.size());
+  sortedSlots.reserve(roster.size());
+  for (size_t i = 0; i < roster.size(); i++) {
+    sortedSlots.add(append(roster.get(i)));
+  }
+  if (sortedSlots.isEmpty())
+    return;
+
+  // Equal names keep their roster order
+  size_t *slots = &sortedSlots.get(0);
+  std::sort(slots, slots + sortedSlots.size(), [this](size_t a, size_t b) {
+    int order = strcmp(names.get(a).c_str(), names.get(b).c_str());
+    return order != 0 ? order < 0 : a < b;
+  });
+}
+
+/**
+ * @brief Appends a member to the roster without sorting its name.
+ *
+ * @param member The member to append.
+ * @return The roster slot of the appended member.
+ */
+size_t MemberIndex::append(const MemberRecord &member) {
+  size_t slot = members.size();
+  MemberRecord record = member;
+  record.prepareDisplay();
+
+  members.add(std::move(record));
+  names.add(normalize(member.name));
+  if (member.uid.length() > 0)
+    uidSlots.update(member.uid, slot);
+
+  return slot;
+}
+
+/**
+ * @brief Adds a member to the index.
+ * The member is appended to the roster and its normalised name is inserted
+ * into the sorted name array at its ordered position. Use @ref rebuild to
+ * index a whole roster.
+ *
+ * @param member The member to add.
+ * @return The roster slot of the added member.
+ */
+size_t MemberIndex::add(const MemberRecord &member) {
+  size_t slot = append(member);
+  sortedSlots.add(upperBound(names.get(slot)), slot);
+  return slot;
+}
+
+/**
+ * @brief Removes all members from the index.
+ */
+void MemberIndex::clear() {
+  members.clear();
+  names.clear();
+  sortedSlots.clear();
+  uidSlots.clear();
+}
+
+/**
+ * @brief Gets the number of members in the index.
+ *
+ * @return The number of indexed members.
+ */
+size_t MemberIndex::size() const { return members.size(); }
+
+/**
+ * @brief Gets the member stored at a roster slot.
+ *
+ * @param slot The roster slot of the member.
+ * @throws std::out_of_range If the slot is out of range.
+ * @return The member record at the roster slot.
+ */
+const MemberRecord &MemberIndex::get(size_t slot) const {
+  return members.get(slot);
+}
+
+/**
+ * @brief Finds a member by name.
+ * The name is normalised before searching, so case and spacing differences
+ * are ignored.
+ *
+ * @param name The name of the member to search for.
+ * @return The roster slot of the member, or -1 if not found.
+ */
+int MemberIndex::findByName(const String &name) const {
+  String key = normalize(name);
+  size_t position = lowerBound(key);
+  if (position < sortedSlots.size()) {
+    size_t slot = sortedSlots.get(position);
+    if (names.get(slot).equals(key))
+      return slot;
+  }
+  return -1;
+}
+
+/**
+ * @brief Finds a member by card UID.
+ *
+ * @param uid The UID of the member's ID card.
+ * @return The roster slot of the member, or -1 if not found.
+ */
+int MemberIndex::findByUID(const String &uid) const {
+  const size_t *slot = uidSlots.find(uid);
+  return slot ? (int)*slot : -1;
+}
+
+/**
+ * @brief Searches members whose name starts with a prefix.
+ * This method runs a binary search over the sorted names, so its cost
+ * depends on the number of results rather than the roster size.
+ *
+ * @param prefix The prefix of the member name.
+ * @param limit The maximum number of results.
+ * @return The matching members in alphabetical order.
+ */
+ArrayList<NameMatch> MemberIndex::searchPrefix(const String &prefix,
+                                               size_t limit) const {
+  ArrayList<NameMatch> result;
+  String key = normalize(prefix);
+
+  for (size_t i = lowerBound(key); i < sortedSlots.size(); i++) {
+    if (result.size() >= limit)
+      break;
+
+    size_t slot = sortedSlots.get(i);
+    const String &name = names.get(slot);
+    if (!name.startsWith(key))
+      break;
+
+    result.add(NameMatch{slot, (uint8_t)(name.equals(key) ? 0 : 1)});
+  }
+  return result;
+}
+
+/**
+ * @brief Suggests members that match a possibly misspelt query.
+ * This method ranks every member with @ref rankName and returns the best
+ * matches, ordered by rank and then alphabetically.
+ *
+ * @param query The text typed by the operator.
+ * @param limit The maximum number of results.
+ * @return The best matching members.
+ */
+ArrayList<NameMatch> MemberIndex::suggest(const String &query,
+                                          size_t limit) const {
+  ArrayList<NameMatch> result;
+  String key = normalize(query);
+  if (key.length() == 0 || limit == 0)
+    return result;
+
+  for (size_t i = 0; i < sortedSlots.size(); i++) {
+    size_t slot = sortedSlots.get(i);
+    uint8_t score = rankName(key, names.get(slot));
+    if (score == NO_MATCH)
+      continue;
+
+    // Keep the results ordered by rank, ties stay in alphabetical order
+    size_t position = result.size();
+    while (position > 0 && result.get(position - 1).score > score) {
+      position--;
+    }
+    if (position >= limit)
+      continue;
+
+    result.add(position, NameMatch{slot, score});
+    if (result.size() > limit)
+      result.remove(result.size() - 1);
+  }
+  return result;
+}
@@ -0,0 +1,50 @@
+#include <MemberRecord.h>
+
+// Longest abbreviated name shown on the OLED, longer names are truncated
+static const size_t MAX_DISPLAY_NAME = 48;
+
+/**
+ * @brief Computes the display strings of the member.
+ * This method abbreviates every name part after the first one to its
+ * initial, e.g. "Budi Santoso Wijaya" becomes "Budi S. W.". A name part
+ * starting with an apostrophe is abbreviated to the letter after it.
+ * The name is built in a stack buffer, so only the resulting String
+ * is allocated.
+ */
+void MemberRecord::prepareDisplay() {
+  char buffer[MAX_DISPLAY_NAME + 1];
+  size_t length = 0;
+
+  const char *text = name.c_str();
+  size_t i = 0;
+
+  // Skip leading spaces and copy the first name part
+  while (text[i] == ' ')
+    i++;
+  while (text[i] != '\0' && text[i] != ' ' && length < MAX_DISPLAY_NAME)
+    buffer[length++] = text[i++];
+
+  // Abbreviate every following name part to its initial
+  while (text[i] != '\0') {
+    if (text[i] == ' ') {
+      i++;
+      continue;
+    }
+
+    char initial = text[i];
+    if (initial == '\'')
+      initial = text[i + 1];
+
+    if (initial != '\0' && initial != ' ' && length + 3 <= MAX_DISPLAY_NAME) {
+      buffer[length++] = ' ';
+      buffer[length++] = initial;
+      buffer[length++] = '.';
+    }
+
+    while (text[i] != '\0' && text[i] != ' ')
+      i++;
+  }
+
+  buffer[length] = '\0';
+  displayName = buffer;
+}
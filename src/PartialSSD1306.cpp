@@ -0,0 +1,151 @@
+#include <PartialSSD1306.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// Largest I2C transmission of the Wire library, including the control byte
+#if defined(I2C_BUFFER_LENGTH)
+#define OLED_WIRE_MAX (I2C_BUFFER_LENGTH < 256 ? I2C_BUFFER_LENGTH : 256)
+#else
+#define OLED_WIRE_MAX 32
+#endif
+
+// Most data bytes in a transmission, after the control byte
+#define OLED_DATA_MAX (OLED_WIRE_MAX - 1)
+
+// Control bytes of an I2C transmission, followed by commands or by data
+#define OLED_CONTROL_COMMANDS 0x00
+#define OLED_CONTROL_DATA 0x40
+
+/**
+ * @brief Constructor for the PartialSSD1306 class.
+ *
+ * @param width The width of the display in pixels.
+ * @param height The height of the display in pixels.
+ * @param twi The I2C bus of the display.
+ * @param resetPin The reset pin of the display, or -1 if it has none.
+ * @param clkDuring The I2C clock while the display is updated.
+ * @param clkAfter The I2C clock restored after the update.
+ */
+PartialSSD1306::PartialSSD1306(uint8_t width, uint8_t height, TwoWire *twi,
+                               int8_t resetPin, uint32_t clkDuring,
+                               uint32_t clkAfter)
+    : Adafruit_SSD1306(width, height, twi, resetPin, clkDuring, clkAfter),
+      shadow(nullptr), isShadowValid(false) {}
+
+/**
+ * @brief Destructor for the PartialSSD1306 class.
+ * Frees the shadow framebuffer.
+ */
+PartialSSD1306::~PartialSSD1306() { free(shadow); }
+
+/**
+ * @brief Sets up the display and allocates the shadow framebuffer.
+ * The first @ref display after this call sends the whole screen. Without
+ * memory for the shadow, every update sends the whole screen.
+ *
+ * @param switchvcc The VCC source of the display.
+ * @param i2caddr The I2C address of the display.
+ * @param reset Whether to reset the display.
+ * @param periphBegin Whether to start the I2C bus.
+ * @return True if the display was set up, false otherwise.
+ */
+bool PartialSSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset,
+                           bool periphBegin) {
+  if (!Adafruit_SSD1306::begin(switchvcc, i2caddr, reset, periphBegin))
+    return false;
+
+  if (shadow == nullptr)
+    shadow = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8));
+  isShadowValid = false;
+  return true;
+}
+
+/**
+ * @brief Sends a list of commands in a single I2C transmission.
+ *
+ * @param commands The command bytes.
+ * @param length The number of command bytes.
+ */
+void PartialSSD1306::sendCommands(const uint8_t *commands, size_t length) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)OLED_CONTROL_COMMANDS);
+  wire->write(commands, length);
+  wire->endTransmission();
+}
+
+/**
+ * @brief Sends a column range of a page from the framebuffer.
+ * The range is set as the address window of the display, so the data is
+ * written to it without addressing every byte.
+ *
+ * @param page The page to send.
+ * @param firstColumn The first column to send.
+ * @param lastColumn The last column to send.
+ */
+void PartialSSD1306::sendRegion(uint8_t page, uint8_t firstColumn,
+                                uint8_t lastColumn) {
+  const uint8_t window[] = {SSD1306_PAGEADDR,   page,        page,
+                            SSD1306_COLUMNADDR, firstColumn, lastColumn};
+  sendCommands(window, sizeof(window));
+
+  const uint8_t *data = buffer + page * WIDTH + firstColumn;
+  size_t remaining = lastColumn - firstColumn + 1;
+  while (remaining > 0) {
+    size_t chunk = remaining < OLED_DATA_MAX ? remaining : OLED_DATA_MAX;
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)OLED_CONTROL_DATA);
+    wire->write(data, chunk);
+    wire->endTransmission();
+    data += chunk;
+    remaining -= chunk;
+  }
+}
+
+/**
+ * @brief Sends the changed part of the framebuffer to the display.
+ * Replaces Adafruit_SSD1306::display(), the whole screen is only sent on
+ * the first update, after @ref invalidate, or if the display isn't on I2C.
+ */
+void PartialSSD1306::display() {
+  size_t pages = (HEIGHT + 7) / 8;
+  if (wire == nullptr || shadow == nullptr || !isShadowValid) {
+    Adafruit_SSD1306::display();
+    if (shadow != nullptr) {
+      memcpy(shadow, buffer, WIDTH * pages);
+      isShadowValid = true;
+    }
+    return;
+  }
+
+#if ARDUINO >= 157
+  wire->setClock(wireClk);
+#endif
+  for (size_t page = 0; page < pages; page++) {
+    const uint8_t *current = buffer + page * WIDTH;
+    uint8_t *sent = shadow + page * WIDTH;
+
+    int16_t first = 0;
+    while (first < WIDTH && current[first] == sent[first])
+      first++;
+    if (first == WIDTH)
+      continue; // The page didn't change
+
+    int16_t last = WIDTH - 1;
+    while (current[last] == sent[last])
+      last--;
+
+    sendRegion(page, first, last);
+    memcpy(sent + first, current + first, last - first + 1);
+  }
+#if ARDUINO >= 157
+  wire->setClock(restoreClk);
+#endif
+}
+
+/**
+ * @brief Makes the next @ref display send the whole screen.
+ * Needed when the display RAM was changed without this class, such as
+ * after the display was reset.
+ */
+void PartialSSD1306::invalidate() { isShadowValid = false; }
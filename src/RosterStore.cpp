@@ -0,0 +1,146 @@
+#include <RosterStore.h>
+
+/**
+ * @brief Constructor for the RosterHandle class.
+ * Only the RosterStore creates handles, after it has registered the reader.
+ *
+ * @param store The store the snapshot belongs to.
+ * @param snapshot The snapshot held by the handle.
+ * @param parity The reader epoch parity the handle is registered in.
+ */
+RosterHandle::RosterHandle(const RosterStore *store,
+                           const RosterSnapshot *snapshot, uint8_t parity)
+    : store(store), snapshot(snapshot), parity(parity) {}
+
+/**
+ * @brief Move constructor for the RosterHandle class.
+ * The moved-from handle no longer holds the snapshot.
+ *
+ * @param other The handle to move from.
+ */
+RosterHandle::RosterHandle(RosterHandle &&other)
+    : store(other.store), snapshot(other.snapshot), parity(other.parity) {
+  other.store = nullptr;
+  other.snapshot = nullptr;
+}
+
+/**
+ * @brief Destructor for the RosterHandle class.
+ * Releases the snapshot, so the writer can reclaim it once it's retired.
+ */
+RosterHandle::~RosterHandle() {
+  if (store != nullptr)
+    store->readers[parity].fetch_sub(1);
+}
+
+/**
+ * @brief Gets the member index of the snapshot.
+ *
+ * @return The member index held by the handle.
+ */
+const MemberIndex &RosterHandle::operator*() const { return snapshot->index; }
+
+/**
+ * @brief Accesses the member index of the snapshot.
+ *
+ * @return A pointer to the member index held by the handle.
+ */
+const MemberIndex *RosterHandle::operator->() const {
+  return &snapshot->index;
+}
+
+/**
+ * @brief Gets the version of the snapshot.
+ *
+ * @return The version number of the snapshot held by the handle.
+ */
+uint32_t RosterHandle::version() const { return snapshot->version; }
+
+/**
+ * @brief Constructor for the RosterStore class.
+ * The store starts with an empty snapshot, so readers always get a roster.
+ */
+RosterStore::RosterStore() : current(new RosterSnapshot()), epoch(0) {
+  readers[0] = 0;
+  readers[1] = 0;
+}
+
+/**
+ * @brief Destructor for the RosterStore class.
+ * Frees the current snapshot. Every handle must be released before.
+ */
+RosterStore::~RosterStore() { delete current.load(); }
+
+/**
+ * @brief Acquires a read handle of the current snapshot.
+ * This method never blocks: it registers the reader in the current epoch
+ * and only retries if the writer flipped the epoch at the same time.
+ *
+ * @return A handle of the current snapshot.
+ */
+RosterHandle RosterStore::acquire() const {
+  for (;;) {
+    uint32_t readerEpoch = epoch.load();
+    uint8_t parity = readerEpoch & 1;
+
+    readers[parity].fetch_add(1);
+    RosterSnapshot *snapshot = current.load();
+    if (epoch.load() == readerEpoch)
+      return RosterHandle(this, snapshot, parity);
+
+    readers[parity].fetch_sub(1);
+  }
+}
+
+/**
+ * @brief Publishes a snapshot and reclaims the previous one.
+ * The writer waits for the readers of the previous snapshot, the readers
+ * themselves are never blocked. Must be called with the writer lock held.
+ *
+ * @param next The snapshot to publish.
+ */
+void RosterStore::swap(RosterSnapshot *next) {
+  RosterSnapshot *previous = current.exchange(next);
+
+  // Every reader that could still hold the previous snapshot registered in
+  // one of the two epochs before the swap, wait for both to drain
+  for (int i = 0; i < 2; i++) {
+    uint8_t parity = epoch.fetch_add(1) & 1;
+    while (readers[parity].load() > 0) {
+      delay(1);
+    }
+  }
+  delete previous;
+}
+
+/**
+ * @brief Publishes a new roster.
+ * The member index is built before the writer lock is taken, so the swap
+ * itself is the only step that touches the shared state.
+ *
+ * @param roster The members of the new roster.
+ */
+void RosterStore::publish(const ArrayList<MemberRecord> &roster) {
+  RosterSnapshot *next = new RosterSnapshot();
+  next->index.rebuild(roster);
+
+  std::lock_guard<std::mutex> lock(writer);
+  next->version = current.load()->version + 1;
+  swap(next);
+}
+
+/**
+ * @brief Adds a member to the roster.
+ * The current snapshot is copied, the member is added to the copy, and the
+ * copy is published as a new snapshot.
+ *
+ * @param member The member to add.
+ */
+void RosterStore::add(const MemberRecord &member) {
+  std::lock_guard<std::mutex> lock(writer);
+
+  RosterSnapshot *next = new RosterSnapshot(*current.load());
+  next->index.add(member);
+  next->version++;
+  swap(next);
+}
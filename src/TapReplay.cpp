@@ -0,0 +1,310 @@
+#include <TapReplay.h>
+
+#include <algorithm>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Constructor for the ReplayCardSource class.
+ * The source starts without a script, so it only replays scheduled lines.
+ */
+ReplayCardSource::ReplayCardSource()
+    : scheduleLock(xSemaphoreCreateMutexStatic(&scheduleLockBuffer)),
+      script(nullptr), startedAt(0), isStarted(false), isEnded(false),
+      isReported(false), replayed(0), taken(0), maxLag(0), parseFailures(0) {}
+
+/**
+ * @brief Parses a line of the script and schedules its tap.
+ * The first tap of a replay, or the first tap after its end, starts a new
+ * replay. Must be called with the schedule lock held.
+ *
+ * @param line The line, without its line break.
+ * @return True if the line was valid, false otherwise.
+ */
+bool ReplayCardSource::parseLine(const char *line) {
+  while (isspace((unsigned char)*line))
+    line++;
+  if (*line == '\0' || *line == '#')
+    return true;
+  if (strncmp(line, "END", 3) == 0) {
+    isEnded = true;
+    return true;
+  }
+
+  char *cursor;
+  ScheduledTap tap;
+  tap.offset = strtoul(line, &cursor, 10);
+  if (cursor == line)
+    return false;
+
+  // The UID follows as hex bytes separated by spaces
+  for (;;) {
+    while (isspace((unsigned char)*cursor))
+      cursor++;
+    if (*cursor == '\0')
+      break;
+
+    char *next;
+    unsigned long value = strtoul(cursor, &next, 16);
+    if (next == cursor || value > 0xFF || tap.uid.size == CARD_UID_MAX_SIZE)
+      return false;
+    tap.uid.bytes[tap.uid.size++] = value;
+    cursor = next;
+  }
+  if (tap.uid.size == 0)
+    return false;
+
+  if (!isStarted || isEnded) {
+    startedAt = millis();
+    isStarted = true;
+    isEnded = false;
+    isReported = false;
+    replayed = 0;
+    taken = 0;
+    maxLag = 0;
+  }
+  pending.add(tap);
+  return true;
+}
+
+/**
+ * @brief Reads the next line of the script.
+ * A line that doesn't fit the buffer is read to its end and dropped, so
+ * its rest isn't mistaken for the next line. Must be called with the
+ * schedule lock held.
+ *
+ * @param line Receives the line, without its line break.
+ * @param size The size of the buffer, including the terminator.
+ * @return True if the line fit the buffer, false if it was too long.
+ */
+bool ReplayCardSource::readLine(char *line, size_t size) {
+  size_t length = script->readBytesUntil('\n', line, size - 1);
+  line[length] = '\0';
+  if (length < size - 1)
+    return true;
+
+  // The buffer is full, the line only fit if its line break comes next
+  int next = script->peek();
+  if (next < 0 || next == '\n') {
+    script->read();
+    return true;
+  }
+
+  while (script->available() > 0 && script->read() != '\n') {
+  }
+  return false;
+}
+
+/**
+ * @brief Puts every tap that's due into the simulated field.
+ * The script is read one tap ahead, so the time of the next tap is known.
+ *
+ * @param now The current time in milliseconds.
+ * @return The time until the next tap is due, at most REPLAY_POLL_INTERVAL.
+ */
+uint32_t ReplayCardSource::release(uint32_t now) {
+  SemaphoreGuard guard(scheduleLock);
+  char line[REPLAY_LINE_SIZE];
+
+  for (;;) {
+    while (pending.isEmpty() && script != nullptr) {
+      if (script->available() <= 0) {
+        script = nullptr;
+        isEnded = true;
+        break;
+      }
+      if (!readLine(line, sizeof(line)) || !parseLine(line))
+        parseFailures++;
+    }
+    if (pending.isEmpty())
+      return REPLAY_POLL_INTERVAL;
+
+    const ScheduledTap &next = pending.get(0);
+    uint32_t elapsed = now - startedAt;
+    if (elapsed < next.offset) {
+      uint32_t untilDue = next.offset - elapsed;
+      return untilDue < REPLAY_POLL_INTERVAL ? untilDue : REPLAY_POLL_INTERVAL;
+    }
+
+    maxLag = std::max(maxLag, elapsed - next.offset);
+    tap(next.uid);
+    replayed++;
+    pending.remove(0);
+  }
+}
+
+/**
+ * @brief Sets the script the taps are read from while the replay runs.
+ * The replay starts at the first tap of the script.
+ *
+ * @param stream The script, such as a file in LittleFS. Must stay open
+ * until it's fully read.
+ */
+void ReplayCardSource::setScript(Stream &stream) {
+  SemaphoreGuard guard(scheduleLock);
+  script = &stream;
+}
+
+/**
+ * @brief Schedules a line of a script, such as one received over a serial
+ * port. Lines must be scheduled in the order of their taps, and before
+ * their taps are due. Can be called from any task.
+ *
+ * @param line The line, without its line break.
+ * @return True if the line was valid, false otherwise.
+ */
+bool ReplayCardSource::schedule(const char *line) {
+  SemaphoreGuard guard(scheduleLock);
+  bool isParsed = parseLine(line);
+  if (!isParsed)
+    parseFailures++;
+  return isParsed;
+}
+
+/**
+ * @brief Waits until a tap of the replay is in the field.
+ * Due taps are released while waiting, at least every REPLAY_POLL_INTERVAL
+ * milliseconds.
+ *
+ * @param timeoutMs The longest time to wait in milliseconds.
+ * @return True if a card would answer a request, false otherwise.
+ */
+bool ReplayCardSource::waitForCard(uint32_t timeoutMs) {
+  uint32_t started = millis();
+  for (;;) {
+    uint32_t untilDue = release(millis());
+    uint32_t elapsed = millis() - started;
+    uint32_t remaining = elapsed < timeoutMs ? timeoutMs - elapsed : 0;
+
+    if (SimulatedCardSource::waitForCard(std::min(untilDue, remaining)))
+      return true;
+    if (remaining <= untilDue)
+      return false;
+  }
+}
+
+/**
+ * @brief Reads a tap of the replay and counts it as taken.
+ *
+ * @param uid Receives the UID of the card.
+ * @return True if a card was read, false otherwise.
+ */
+bool ReplayCardSource::readCard(CardUID &uid) {
+  if (!SimulatedCardSource::readCard(uid))
+    return false;
+
+  SemaphoreGuard guard(scheduleLock);
+  taken++;
+  return true;
+}
+
+/**
+ * @brief Checks if the replay has ended since the last call.
+ * A replay has ended once its script is fully read, or its END line was
+ * scheduled, and the reader task has taken every tap from the field.
+ *
+ * @return True once per replay when it has ended, false otherwise.
+ */
+bool ReplayCardSource::takeFinished() {
+  SemaphoreGuard guard(scheduleLock);
+  if (!isEnded || isReported || script != nullptr || !pending.isEmpty() ||
+      replayed == 0 || taken < replayed)
+    return false;
+
+  isReported = true;
+  return true;
+}
+
+/**
+ * @brief Gets the number of taps put into the field by the current replay.
+ *
+ * @return The number of replayed taps.
+ */
+uint32_t ReplayCardSource::getReplayed() {
+  SemaphoreGuard guard(scheduleLock);
+  return replayed;
+}
+
+/**
+ * @brief Gets the longest delay between the time of a tap in the script and
+ * the moment it was put into the field. A large lag means the reader task
+ * couldn't keep up with the script.
+ *
+ * @return The longest lag of the current replay in milliseconds.
+ */
+uint32_t ReplayCardSource::getMaxLag() {
+  SemaphoreGuard guard(scheduleLock);
+  return maxLag;
+}
+
+/**
+ * @brief Gets the number of lines that were rejected since the last call,
+ * and starts counting again. A line is rejected if it isn't a tap, blank,
+ * a comment or END, or if it's longer than REPLAY_LINE_SIZE.
+ *
+ * @return The number of rejected lines.
+ */
+uint32_t ReplayCardSource::takeParseFailures() {
+  SemaphoreGuard guard(scheduleLock);
+  uint32_t failures = parseFailures;
+  parseFailures = 0;
+  return failures;
+}
+
+/**
+ * @brief Constructor for the TapLatencyStats class.
+ */
+TapLatencyStats::TapLatencyStats() : count(0), maximum(0) {}
+
+/**
+ * @brief Records the latency of a processed tap.
+ *
+ * @param latencyMs The time from reading the tap until it was processed.
+ */
+void TapLatencyStats::record(uint32_t latencyMs) {
+  samples[count % TAP_LATENCY_SAMPLES] = latencyMs;
+  count++;
+  maximum = std::max(maximum, latencyMs);
+}
+
+/**
+ * @brief Forgets every recorded latency.
+ */
+void TapLatencyStats::reset() {
+  count = 0;
+  maximum = 0;
+}
+
+/**
+ * @brief Gets the number of latencies recorded since the last reset.
+ *
+ * @return The number of processed taps.
+ */
+size_t TapLatencyStats::getCount() const { return count; }
+
+/**
+ * @brief Gets the longest latency recorded since the last reset.
+ *
+ * @return The longest latency in milliseconds.
+ */
+uint32_t TapLatencyStats::getMax() const { return maximum; }
+
+/**
+ * @brief Computes a percentile of the recent latencies, by nearest rank.
+ *
+ * @param percent The percentile, between 1 and 100.
+ * @return The latency in milliseconds, or 0 if nothing was recorded.
+ */
+uint32_t TapLatencyStats::percentile(uint8_t percent) const {
+  size_t size = std::min(count, (size_t)TAP_LATENCY_SAMPLES);
+  if (size == 0)
+    return 0;
+
+  uint32_t sorted[TAP_LATENCY_SAMPLES];
+  std::copy(samples, samples + size, sorted);
+
+  size_t rank = std::max((percent * size + 99) / 100, (size_t)1);
+  std::nth_element(sorted, sorted + rank - 1, sorted + size);
+  return sorted[rank - 1];
+}
@@ -19,6 +19,91 @@ WiFiClientSecure client;
 
 // Create instance of MFRC522 (RFID)
 MFRC522 rfid(SS_PIN, RST_PIN);
+
+// Import package for Card Reader
+#include <CardReader.h>
+
+// Import package for Ring Buffer (Local)
+#include <RingBuffer.h>
+
+// Import package for Tap Pipeline settings (Local)
+#include <TapPipeline.h>
+
+// Import package for FreeRTOS Semaphore Guard
+#include <SemaphoreGuard.h>
+
+#include <atomic>
+
+// Initial IRQ pin of MFRC522 (RFID)
+#define IRQ_PIN 4
+
+// Time in milliseconds the result of a tap stays on the OLED before the tap
+// prompt returns, a queued tap replaces it right away
+#define RESULT_SCREEN_TIMEOUT 3000
+
+// Create instance of Card Source woken by the IRQ pin of MFRC522 (RFID)
+MFRC522CardSource cardSource(rfid, IRQ_PIN);
+
+// Serialises the reader task and the register menu on MFRC522 (RFID)
+StaticSemaphore_t rfidLockBuffer;
+SemaphoreHandle_t rfidLock;
+
+// Create instance of Tap Debouncer for the reader task
+TapDebouncer tapDebouncer(TAP_DEBOUNCE_WINDOW);
+
+// Create instance of Ring Buffer passing taps from the reader task to the
+// attendance task
+RingBuffer<TapEvent, TAP_QUEUE_SIZE> tapQueue;
+
+// Number of taps dropped because the tap queue was full
+std::atomic<uint32_t> droppedTaps(0);
+
+// Number of card reads rejected by the tap debouncer
+std::atomic<uint32_t> debouncedTaps(0);
+
+// Import package for Signed Card Records
+#include <CardRecord.h>
+
+// Write a signed member record to cards at registration and resolve
+// members from it at tap time, without a server call
+#define SIGNED_CARD_RECORDS true
+
+// Create instance of Card Signer for the member records on the cards
+CardSigner cardSigner;
+
+// Replace the reader with taps replayed from a script, for load testing
+#define TAP_REPLAY_MODE false
+
+#if TAP_REPLAY_MODE
+// Import package for Tap Replay
+#include <TapReplay.h>
+
+// Import package for LittleFS File System
+#include <LittleFS.h>
+
+// Script replayed from LittleFS, "TAP" lines on the receiver port are
+// replayed if the file doesn't exist
+#define TAP_REPLAY_FILE "/taps.txt"
+
+// Receive buffer of the receiver port, so script lines sent in a burst
+// aren't lost while a tap is processed
+#define TAP_REPLAY_RX_BUFFER 4096
+
+// Create instance of Replay Card Source for the reader task
+ReplayCardSource replaySource;
+
+// Script file of the replay, kept open while it's replayed
+File replayFile;
+
+// Create instance of Tap Latency Stats for the replay report
+TapLatencyStats tapLatency;
+
+// Card source read by the reader task
+CardSource &tapSource = replaySource;
+#else
+// Card source read by the reader task
+CardSource &tapSource = cardSource;
+#endif
 // ====================================================================
 
 // ========================[ System Databases ]========================
@@ -28,14 +113,54 @@ MFRC522 rfid(SS_PIN, RST_PIN);
 // Import package for Preferences Database (Local)
 #include <Preferences.h>
 
+// Import package for Roster Store (Local)
+#include <RosterStore.h>
+
+// Interval between background member roster refreshes
+#define ROSTER_SYNC_INTERVAL 300000
+
+// Import package for Attendance Ledger (Local)
+#include <AttendanceLedger.h>
+
+// Import package for LRU Cache (Local)
+#include <LRUCache.h>
+
+// Number of recently accessed member records kept in RAM
+#define MEMBER_CACHE_CAPACITY 8
+
+// Import package for Split String (Local)
+#include <SplitString.h>
+
+// Size of the arena buffer reused by every card tap
+#define TAP_ARENA_SIZE 512
+
 // Initialize PostmanAPI URL Server
 String apiUrl = "https://fostipresensiapi.vercel.app";
 
 // Create instance of PostmanAPI Supabase Database
 PostmanAPI api(client, apiUrl);
 
+// Create instance of PostmanAPI for the background roster refresh
+// It has its own client, so a refresh never shares a connection with a tap
+WiFiClientSecure syncClient;
+PostmanAPI syncApi(syncClient, apiUrl);
+
 // Create instance of LittleFS Database
 Preferences pref;
+
+// Create instance of Roster Store for the member roster snapshots
+RosterStore roster;
+
+// Create instance of Attendance Ledger for the current event check-ins
+AttendanceLedger attendanceLedger;
+
+// Create instance of LRU Cache for recently accessed member records
+LRUCache<String, MemberRecord> memberCache(MEMBER_CACHE_CAPACITY);
+// Roster version the cached member records were taken from
+uint32_t memberCacheVersion = 0;
+
+// Create instance of Arena for the short-lived data of a card tap
+Arena tapArena(TAP_ARENA_SIZE);
 // ====================================================================
 
 // ======================[ OLED 128x64 0.96 Inch ]=====================
@@ -43,6 +168,9 @@ Preferences pref;
 #include <Adafruit_SSD1306.h>
 #include <Wire.h>
 
+// Import package for OLED partial refresh
+#include <PartialSSD1306.h>
+
 // Import the OLED text fonts style
 #include <Fonts/FreeSansBold6pt7b.h>
 #include <Fonts/FreeSansBold7pt7b.h>
@@ -53,9 +181,9 @@ Preferences pref;
 #define OLED_RESET -1
 #define OLED_SCREEN_ADDRESS 0x3C
 
-// Create instance of OLED 128x64
-Adafruit_SSD1306 display(OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT, &Wire,
-                         OLED_RESET);
+// Create instance of OLED 128x64, only the changed part of a screen is sent
+PartialSSD1306 display(OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT, &Wire,
+                       OLED_RESET);
 // ====================================================================
 
 // ===========================[ NTP CLIENT ]===========================
@@ -78,6 +206,12 @@ NTPClient ntpClient(ntpUDP, serverName, timezoneGMT * 3600, updateInterval);
 // =========================[ Debug Settings ]==========================
 #define DEBUG_ALL true
 
+// Import package for heap fragmentation reports
+#include <esp_heap_caps.h>
+
+// Number of card taps between two heap fragmentation reports
+#define HEAP_LOG_INTERVAL 100
+
 // Define the HardwareSerial object for the chosen UART
 HardwareSerial ReceiverPort(1);    // Using UART1
 HardwareSerial TransmitterPort(2); // Using UART2
@@ -90,9 +224,11 @@ enum PresenceOption { NONE, PARTICIPANT, COMMITTEE, BPHI };
 TaskHandle_t taskMainHandler;
 TaskHandle_t taskRegisterHandler;
 TaskHandle_t taskAttendanceHandler;
+TaskHandle_t taskCardReaderHandler;
 
 TaskHandle_t taskLoadingHandler;
 TaskHandle_t taskCheckConnectionHandler;
+TaskHandle_t taskRosterSyncHandler;
 
 // ========================[ Global Variables ]========================
 MainMenuOption mainMenuOption =
@@ -105,6 +241,14 @@ String receivedData = "";
 String currentEvent = "";  // Current event for attendance
 bool showDivision = false; // Flag to show division in attendance
 
+// Running event read by the roster sync task, applied by the attendance task
+String fetchedEvent = "";
+// Guards the fetched event, it's written and read by different tasks
+StaticSemaphore_t eventLockBuffer;
+SemaphoreHandle_t eventLock;
+// Whether the current event changed since the last new check-in
+bool hasEventChanged = false;
+
 // WiFi & others variables initialization
 int MAX_WIFI_RETRIES = 32;   // Max retries for WiFi connection
 int currentWiFiDot = -1;     // Current dot for WiFi connection
@@ -196,35 +340,66 @@ void TaskLoadingBar(void *pvParameters);
 void TaskMain(void *pvParameters);
 void TaskRegister(void *pvParameters);
 void TaskAttendance(void *pvParameters);
+void TaskCardReader(void *pvParameters);
 void TaskCheckConnection(void *pvParameters);
+void TaskRosterSync(void *pvParameters);
 
 /**
- * @brief Split a string by a given delimiter.
- * This function takes an input string and a delimiter character,
- * and splits the string into an ArrayList of substrings based
- * on the delimiter.
+ * @brief Log the heap fragmentation over Serial.
+ * This function reports the free heap, the largest free block, and the share
+ * of the free heap outside of the largest block, together with the usage of
+ * the column pool and the tap arena. Comparing the reports before and after
+ * a long run of card taps shows whether the tap path fragments the heap.
+ * With ENABLE_COLLECTION_STATS, the counters of every collection follow.
  *
- * @param str The input string to be split.
- * @param delimiter The character used as the delimiter.
- * @return An ArrayList containing the split substrings.
+ * @param label The label printed with the report.
  */
-ArrayList<String> splitString(const String &str, char delimiter) {
-  ArrayList<String> result;
-  String temp = "";
-  for (unsigned int i = 0; i < str.length(); i++) {
-    if (str[i] == delimiter) {
-      result.add(temp);
-      temp = "";
-    } else {
-      temp += str[i];
-    }
-  }
-  if (temp.length() > 0) {
-    result.add(temp);
-  }
-  return result;
+void logHeapFragmentation(const char *label) {
+  size_t freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  size_t largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  float fragmentation =
+      freeHeap > 0 ? 100.0f * (freeHeap - largestBlock) / freeHeap : 0.0f;
+
+  Serial.printf("[Heap] %s: %u free, %u largest block, %.1f%% fragmented\n",
+                label, freeHeap, largestBlock, fragmentation);
+  Serial.printf("[Heap] Column pool: %u in use, %u heap fallbacks\n",
+                ColumnPool::shared().getUsed(),
+                ColumnPool::shared().getFallbacks());
+  Serial.printf("[Heap] Tap arena: %u bytes peak of %u\n", tapArena.getPeak(),
+                TAP_ARENA_SIZE);
+
+#ifdef ENABLE_COLLECTION_STATS
+  CollectionStats::dump(Serial);
+#endif
 }
 
+#if TAP_REPLAY_MODE
+/**
+ * @brief Print the report of a finished tap replay.
+ * This function prints how many taps were replayed and what became of
+ * them, together with the end-to-end latency percentiles of the processed
+ * taps, then resets the counters for the next replay.
+ */
+void printReplayReport() {
+  Serial.println("=========] Tap Replay Report [=========");
+  Serial.printf("[Replay] %u replayed, %u processed, %u debounced, "
+                "%u dropped\n",
+                replaySource.getReplayed(), tapLatency.getCount(),
+                debouncedTaps.load(), droppedTaps.load());
+  Serial.printf("[Replay] Latency p50 %u ms, p90 %u ms, p99 %u ms, "
+                "max %u ms\n",
+                tapLatency.percentile(50), tapLatency.percentile(90),
+                tapLatency.percentile(99), tapLatency.getMax());
+  Serial.printf("[Replay] Reader lag up to %u ms, %u lines rejected\n",
+                replaySource.getMaxLag(), replaySource.takeParseFailures());
+  Serial.println("=======================================");
+
+  tapLatency.reset();
+  debouncedTaps = 0;
+  droppedTaps = 0;
+}
+#endif
+
 /**
  * @brief Load settings from the Preferences database.
  * This function reads the current event name, show division setting,
@@ -236,19 +411,67 @@ void loadSettings() {
   // Read current event from Preferences Database
   // If the key doesn't exist, read from PostmanAPI Database
   // Otherwise, read the value from the Preferences database
-  HashMap<String, String> eventsColumn;
-  eventsColumn.put("judul", "current_event_name");
-  HashMap<String, String> eventsData =
-      api.readData("/api/event", "", eventsColumn);
+  static constexpr Column eventsColumn[] = {Column::JUDUL};
+  ColumnMap eventsData = api.readData("/api/event", "", eventsColumn);
 
   if (pref.getString("event_name", "").equals("")) {
-    pref.putString("event_name", eventsData.get("current_event_name"));
-    currentEvent = eventsData.get("current_event_name");
+    pref.putString("event_name", eventsData.get(Column::JUDUL));
+    currentEvent = eventsData.get(Column::JUDUL);
   } else {
     currentEvent = pref.getString("event_name");
   }
 }
 
+/**
+ * @brief Load the member roster from the PostmanAPI database.
+ * This function downloads the member table and publishes it as a new
+ * roster snapshot, so members can be searched by name without downloading
+ * the member table on every attempt. Readers keep using the previous
+ * snapshot until the new one is published.
+ *
+ * @param source The PostmanAPI instance used to download the member table.
+ */
+void loadRoster(PostmanAPI &source) {
+  // Keep serving the current roster if the member table can't be read,
+  // an empty or partial table would make every member unknown
+  ArrayList<MemberRecord> members;
+  if (!source.getMembers("/api/mahasiswa", members)) {
+    Serial.println("Failed to load member roster!");
+    return;
+  }
+
+  roster.publish(members);
+  Serial.printf("Loaded %d members into the member roster.\n",
+                members.size());
+}
+
+/**
+ * @brief Send member name suggestions to the companion app.
+ * This function searches the local member index for names matching the
+ * query and sends the ranked results to the TransmitterPort.
+ *
+ * @param query The (partial) member name typed by the operator.
+ */
+void sendNameSuggestions(const String &query) {
+  String callbackData;
+  JsonDocument callbackDoc;
+  callbackDoc["dataType"] = "DATA";
+
+  JsonObject data = callbackDoc["data"].to<JsonObject>();
+  JsonArray suggestions = data["nameSuggestions"].to<JsonArray>();
+  {
+    // The names are copied into the document, so the roster handle is
+    // released before the suggestions are sent
+    RosterHandle members = roster.acquire();
+    ArrayList<NameMatch> matches = members->suggest(query);
+    for (size_t i = 0; i < matches.size(); i++) {
+      suggestions.add(members->get(matches.get(i).slot).name);
+    }
+  }
+  serializeJson(callbackDoc, callbackData);
+  TransmitterPort.println(callbackData);
+}
+
 /**
  * @brief Get the string representation of the presence option.
  * This function takes a PresenceOption enum value and returns
@@ -284,6 +507,21 @@ void setup() {
   // Initialize system components pinout
   SPI.begin(18, 19, 23, SS_PIN);
   rfid.PCD_Init();
+  rfidLock = xSemaphoreCreateMutexStatic(&rfidLockBuffer);
+  cardSource.begin();
+#if SIGNED_CARD_RECORDS
+  cardSource.setRecordBlock(CARD_RECORD_BLOCK);
+#endif
+#if TAP_REPLAY_MODE
+  replaySource.begin();
+  if (LittleFS.begin() && LittleFS.exists(TAP_REPLAY_FILE)) {
+    replayFile = LittleFS.open(TAP_REPLAY_FILE, "r");
+    replaySource.setScript(replayFile);
+    Serial.println("Replaying taps from " TAP_REPLAY_FILE);
+  } else {
+    Serial.println("Replaying taps from the receiver port");
+  }
+#endif
 
   Wire.begin(17, 16);
   if (!display.begin(SSD1306_SWITCHCAPVCC, OLED_SCREEN_ADDRESS)) {
@@ -302,6 +540,9 @@ void setup() {
   xTaskCreate(TaskLoadingBar, "Loading Bar", 2048, NULL, 1,
               &taskLoadingHandler);
 
+#if TAP_REPLAY_MODE
+  ReceiverPort.setRxBufferSize(TAP_REPLAY_RX_BUFFER);
+#endif
   ReceiverPort.begin(115200, SERIAL_8N1, 26, -1);
   TransmitterPort.begin(115200, SERIAL_8N1, -1, 27);
 
@@ -443,6 +684,9 @@ void setup() {
   Serial.println("Connecting to Preferences Database...");
   if (pref.begin("presensiIDCard", false)) {
     Serial.println("Preferences Database connected!");
+    attendanceLedger.begin(pref);
+    eventLock = xSemaphoreCreateMutexStatic(&eventLockBuffer);
+    cardSigner.begin(pref);
   } else {
     Serial.println("Failed to connect to Preferences Database!");
     while (1)
@@ -457,9 +701,13 @@ void setup() {
                           &taskRegisterHandler, 1);
   xTaskCreate(TaskAttendance, "Member Attendance", 8192, NULL, 1,
               &taskAttendanceHandler);
+  xTaskCreate(TaskCardReader, "Card Reader", 4096, NULL, 3,
+              &taskCardReaderHandler);
 
   xTaskCreate(TaskCheckConnection, "Check Connection", 8192, NULL, 2,
               &taskCheckConnectionHandler);
+  xTaskCreate(TaskRosterSync, "Roster Sync", 8192, NULL, 1,
+              &taskRosterSyncHandler);
 
   vTaskSuspend(taskRegisterHandler);   // Suspend the register task
   vTaskSuspend(taskAttendanceHandler); // Suspend the attendance task
@@ -470,6 +718,7 @@ void setup() {
   MAX_WIFI_RETRIES = 32;
 
   loadSettings();           // Load settings from Preferences Database
+  loadRoster(api);          // Load member roster into the roster store
   Serial.setTimeout(1000L); // Reset timeout for serial input
 }
 
@@ -489,6 +738,33 @@ bool isDigitString(const String &str) {
   return true;
 }
 
+/**
+ * @brief Write the signed member record to the card being registered.
+ * This function writes the member ID, NIM and division to the record block
+ * of the card, so later taps identify the member without a server call. The
+ * card must still be selected by the reader.
+ *
+ * @param member The registered member, with the ID assigned by the
+ * PostmanAPI database.
+ * @return True if the record was written, false otherwise.
+ */
+bool writeCardRecord(const MemberRecord &member) {
+  if (member.id == "")
+    return false;
+
+  CardUID uid;
+  uid.size = rfid.uid.size;
+  memcpy(uid.bytes, rfid.uid.uidByte, uid.size);
+
+  CardRecord record;
+  uint8_t block[CARD_BLOCK_SIZE];
+  if (!record.assign(member) || !cardSigner.encode(record, uid, block))
+    return false;
+
+  SemaphoreGuard guard(rfidLock);
+  return cardSource.writeBlock(CARD_RECORD_BLOCK, block);
+}
+
 /**
  * @brief Register data from RFID Card.
  * This function reads the UID from the RFID Card and prompts the user to enter
@@ -496,16 +772,30 @@ bool isDigitString(const String &str) {
  * database.
  */
 void registerData() {
-  HashMap<String, String> memberData;
+  ColumnMap memberData;
   char buffer[64]; // Buffer to hold input data
 
   // Check if a card is present and read its UID
-  if (!rfid.PICC_IsNewCardPresent() || !rfid.PICC_ReadCardSerial()) {
-    Serial.println("Waiting for a card...");
-    TransmitterPort.println("Waiting for a card...");
-    return;
+  // The reader task may still be finishing a scan right after a menu change
+  {
+    SemaphoreGuard guard(rfidLock);
+    if (!rfid.PICC_IsNewCardPresent() || !rfid.PICC_ReadCardSerial()) {
+      Serial.println("Waiting for a card...");
+      TransmitterPort.println("Waiting for a card...");
+      return;
+    }
   }
 
+  // Stop reading the card on every way out, the prompts below can time out
+  // or be cancelled while the card is still selected
+  struct CardRelease {
+    ~CardRelease() {
+      SemaphoreGuard guard(rfidLock);
+      rfid.PICC_HaltA();
+      rfid.PCD_StopCrypto1();
+    }
+  } cardRelease;
+
   String callbackData;
   JsonDocument callbackDoc;
   callbackDoc["dataType"] = "DATA";
@@ -547,7 +837,7 @@ void registerData() {
   Serial.print("Member Card UID: ");
   Serial.println(memberUID);
   TransmitterPort.printf("</nl>Member Card UID: %s\n", memberUID.c_str());
-  memberData.put("uid", memberUID);
+  memberData.put(Column::UID, memberUID);
 
   // ===================[ Prompt for NIM ]===================
   Serial.print("Write Member NIM: ");
@@ -588,13 +878,13 @@ void registerData() {
     Serial.println("Write Member Name: " + name);
     Serial.println("Write Member Division: " + division);
 
-    memberData.put("nim", nim);
-    memberData.put("nama", name);
-    memberData.put("divisi", division);
+    memberData.put(Column::NIM, nim);
+    memberData.put(Column::NAMA, name);
+    memberData.put(Column::DIVISI, division);
   } else {
     String nimAnggota = inputData;
     Serial.println(nimAnggota);
-    memberData.put("nim", nimAnggota);
+    memberData.put(Column::NIM, nimAnggota);
     buffer[0] = '\0'; // Clear buffer
 
     // ===================[ Prompt for Name ]===================
@@ -625,15 +915,16 @@ void registerData() {
 
     String namaAnggota = inputData;
     Serial.println(namaAnggota);
-    memberData.put("nama", namaAnggota);
+    memberData.put(Column::NAMA, namaAnggota);
     buffer[0] = '\0'; // Clear buffer
 
     // =================[ Prompt for Division ]=================
-    HashMap<String, String> divisionList;
-    divisionList.put("RISTEK", "Riset dan Teknologi");
-    divisionList.put("KEOR", "Keorganisasian");
-    divisionList.put("HUBPUB", "Hubungan Publik");
-    divisionList.put("BPI", "Badan Pengurus Inti");
+    static constexpr StaticMap<const char *, const char *, 4> divisionList = {{
+        {"RISTEK", "Riset dan Teknologi"},
+        {"KEOR", "Keorganisasian"},
+        {"HUBPUB", "Hubungan Publik"},
+        {"BPHI", "Badan Pengurus Inti"},
+    }};
 
     Serial.println("============] Division List [============");
     Serial.println("Please select your division from the list below:");
@@ -696,33 +987,16 @@ void registerData() {
       }
 
       // Map input to division key
-      switch (inputData.toInt()) {
-      case 1:
-        inputData = "RISTEK";
-        break;
-      case 2:
-        inputData = "KEOR";
-        break;
-      case 3:
-        inputData = "HUBPUB";
-        break;
-      case 4:
-        inputData = "BPHI";
-        break;
-      }
+      inputData = divisionList.keyAt(inputData.toInt() - 1);
       break;
     }
 
     String namaDivisiSingkat = inputData;
-    String namaDivisiLengkap = divisionList.get(inputData);
+    String namaDivisiLengkap = divisionList.get(inputData.c_str());
     Serial.println(namaDivisiLengkap);
-    memberData.put("divisi", namaDivisiSingkat);
+    memberData.put(Column::DIVISI, namaDivisiSingkat);
     buffer[0] = '\0'; // Clear buffer
   }
-
-  // Stop reading the card
-  rfid.PICC_HaltA();
-  rfid.PCD_StopCrypto1();
   delay(500);
 
   // Save member data to PostmanAPI database
@@ -730,14 +1004,35 @@ void registerData() {
   TransmitterPort.println("</nl>Write data to PostmanAPI database...");
   delay(1000);
 
-  JsonDocument test = memberData.toJson();
-  Serial.println(test.as<String>());
+  memberData.printJsonTo(Serial);
+  Serial.println();
 
-  bool success = api.createData("/api/mahasiswa", memberData.toJson());
+  bool success = api.createData("/api/mahasiswa", memberData);
   if (success) {
+    MemberRecord member;
+    member.id = api.getCreatedId();
+    member.uid = memberData.get(Column::UID);
+    member.nim = memberData.get(Column::NIM);
+    member.name = memberData.get(Column::NAMA);
+    member.division = memberData.get(Column::DIVISI);
+
     Serial.println("Successfully wrote data to PostmanAPI database!");
     TransmitterPort.println(
         "Successfully wrote data to PostmanAPI Server!</nl>");
+
+#if SIGNED_CARD_RECORDS
+    // The card is still selected, so the record is written before it's
+    // halted. A card without the record is looked up on the server.
+    if (writeCardRecord(member)) {
+      Serial.println("Member record written to the card!");
+      TransmitterPort.println("Member record written to the card!</nl>");
+    } else {
+      Serial.println("Member record not written, card is checked online.");
+      TransmitterPort.println(
+          "Member record not written, card is checked online.</nl>");
+    }
+#endif
+    roster.add(member);
   } else {
     Serial.println("Failed to write data to PostmanAPI database!");
     TransmitterPort.println("Failed to write data to PostmanAPI Server!");
@@ -749,6 +1044,22 @@ void registerData() {
   Serial.println();
 }
 
+/**
+ * @brief Drop the cached member records of an older roster.
+ * Cached records are copies of the roster, so they are cleared once a newer
+ * roster is published by a roster load, a roster sync or a registration,
+ * and members changed on the server aren't served stale until evicted.
+ *
+ * @param rosterVersion The version of the roster the caller reads.
+ */
+void syncMemberCache(uint32_t rosterVersion) {
+  if (rosterVersion == memberCacheVersion)
+    return;
+
+  memberCache.clear();
+  memberCacheVersion = rosterVersion;
+}
+
 /**
  * @brief Show member data on the OLED display and Serial Monitor.
  * This function retrieves member data from the PostmanAPI database
@@ -760,43 +1071,65 @@ void registerData() {
  * @param showOnLED If true, the member data will be displayed on the OLED.
  *                  Otherwise, it will only print data to the Serial Monitor.
  *
- * @note This function uses the PostmanAPI to retrieve member data.
+ * @note Member data is rendered from the member cache, the PostmanAPI is
+ *       only used to retrieve members that aren't cached.
  */
 void showMemberData(String UID, bool showOnLED = true) {
-  String *memberUID = api.getMemberByUID("/api/mahasiswa", UID);
+  MemberRecord member;
 
-  // Check if member exists in PostmanAPI database
-  if (memberUID == nullptr) {
-    Serial.printf("Member with UID %s isn't exists in member table!\n", UID);
-    TransmitterPort.printf(
-        "</nl>Member with UID %s isn't exists in member table!</nl></nl>\n",
-        UID);
+  // Render from the member cache, only fetch members that aren't cached
+  syncMemberCache(roster.acquire().version());
+  if (!memberCache.get(UID, member)) {
+    String *memberUID = api.getMemberByUID("/api/mahasiswa", UID);
 
-    display.clearDisplay();
-    display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
-    display.setCursor(8, 60);
-    display.print("Invalid UID Data!");
-    display.display();
-    return;
+    // Check if member exists in PostmanAPI database
+    if (memberUID == nullptr) {
+      Serial.printf("Member with UID %s isn't exists in member table!\n", UID);
+      TransmitterPort.printf(
+          "</nl>Member with UID %s isn't exists in member table!</nl></nl>\n",
+          UID);
+
+      display.clearDisplay();
+      display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
+      display.setCursor(8, 60);
+      display.print("Invalid UID Data!");
+      display.display();
+      return;
+    }
+
+    // Map member data to record fields
+    static constexpr Column column[] = {Column::UID, Column::NIM,
+                                        Column::NAMA, Column::DIVISI};
+    ColumnMap memberData = api.readData("/api/mahasiswa", UID, column);
+
+    member.id = *memberUID;
+    member.uid = memberData.get(Column::UID);
+    member.nim = memberData.get(Column::NIM);
+    member.name = memberData.get(Column::NAMA);
+    member.division = memberData.get(Column::DIVISI);
+    member.prepareDisplay();
+    memberCache.put(UID, member);
+    delete memberUID;
   }
 
-  // Map member data to display columns
-  HashMap<String, String> column;
-  column.put("uid", "Member UID");
-  column.put("nim", "Member NIM");
-  column.put("nama", "Member Name");
-  if (showDivision)
-    column.put("divisi", "Member Division");
-  HashMap<String, String> memberData =
-      api.readData("/api/mahasiswa", UID, column);
+#if DEBUG_ALL
+  Serial.printf("Member cache: %d hits, %d misses\n", memberCache.getHits(),
+                memberCache.getMisses());
+#endif
 
   // Print member data to Serial Monitor
   Serial.println("=========] Member Data [=========");
   TransmitterPort.println("=========] Member Data [=========");
-  memberData.foreach ([](const String &colName, const String &colValue) {
-    Serial.println(colName + ": " + colValue);
-    TransmitterPort.println(colName + ": " + colValue);
-  });
+  Serial.println("Member UID: " + member.uid);
+  TransmitterPort.println("Member UID: " + member.uid);
+  Serial.println("Member NIM: " + member.nim);
+  TransmitterPort.println("Member NIM: " + member.nim);
+  Serial.println("Member Name: " + member.name);
+  TransmitterPort.println("Member Name: " + member.name);
+  if (showDivision) {
+    Serial.println("Member Division: " + member.division);
+    TransmitterPort.println("Member Division: " + member.division);
+  }
   Serial.println("=================================");
   TransmitterPort.println("=================================</nl>");
 
@@ -809,41 +1142,81 @@ void showMemberData(String UID, bool showOnLED = true) {
     display.drawBitmap(0, 0, userBitmap, 50, 60, SSD1306_WHITE);
 
     int currentY = showDivision ? 8 : 16;
-    int currentLine = 1;
-    memberData.foreach ([&currentY, &currentLine](const String &colName,
-                                                  const String &colValue) {
-      display.setCursor(52, currentY);
-      if (currentLine != 3) {
-        display.print(colValue);
-      } else {
-        ArrayList<String> namePart = splitString(colValue, ' ');
-        String firstName = namePart.get(0);
-        String lastName;
-
-        for (int i = 1; i < namePart.size(); i++) {
-          String subname = namePart.get(i);
-
-          if (subname.startsWith("'")) {
-            lastName += subname.substring(1, 2);
-          } else {
-            lastName += subname.substring(0, 1);
-          }
-          lastName += ". ";
-        }
-        lastName.trim();
+    display.setCursor(52, currentY);
+    display.print(member.uid);
+    currentY += 16;
 
-        String name = firstName + " " + lastName;
-        name.trim();
-        display.print(name);
-      }
-      currentY += 16;
-      currentLine++;
-    });
+    display.setCursor(52, currentY);
+    display.print(member.nim);
+    currentY += 16;
+
+    display.setCursor(52, currentY);
+    display.print(member.displayName);
+    currentY += 16;
+
+    if (showDivision) {
+      display.setCursor(52, currentY);
+      display.print(member.division);
+    }
     display.display();
     display.setFont(&FreeSansBold7pt7b);
   }
 }
 
+/**
+ * @brief Fetch the running event from the PostmanAPI database.
+ * This function only stores the event name for @ref applyCurrentEvent, so
+ * it can run in another task than the taps and the server round trip never
+ * delays a tap. The last fetched event is kept if the event can't be read.
+ *
+ * @param source The PostmanAPI instance used to read the event.
+ */
+void fetchCurrentEvent(PostmanAPI &source) {
+  static constexpr Column eventsColumn[] = {Column::JUDUL};
+  ColumnMap eventsData = source.readData("/api/event", "", eventsColumn);
+  String eventName = eventsData.get(Column::JUDUL);
+  if (eventName == "")
+    return;
+
+  SemaphoreGuard guard(eventLock);
+  fetchedEvent = eventName;
+}
+
+/**
+ * @brief Apply the last fetched event as the current event.
+ * This function stores the fetched event as the current event when it
+ * changed, then binds the attendance ledger to it, so check-ins of a
+ * previous event never answer a tap. It doesn't call the server, so it
+ * runs before every tap.
+ */
+void applyCurrentEvent() {
+  String eventName;
+  {
+    SemaphoreGuard guard(eventLock);
+    eventName = fetchedEvent;
+  }
+
+  if (eventName != "" && !eventName.equals(currentEvent)) {
+    pref.putString("event_name", eventName);
+    currentEvent = eventName;
+    hasEventChanged = true;
+  }
+  attendanceLedger.sync(currentEvent);
+}
+
+/**
+ * @brief Check if the current event changed since the last new check-in.
+ * Only a new check-in asks, the log in date of its member on the server may
+ * still belong to the previous event.
+ *
+ * @return True once after every change of the current event.
+ */
+bool takeEventChanged() {
+  bool isEventChanged = hasEventChanged;
+  hasEventChanged = false;
+  return isEventChanged;
+}
+
 /**
  * @brief Show the attendance menu.
  * This function displays the attendance options
@@ -876,36 +1249,93 @@ void showAttendanceMenu() {
  *
  * @param UID The UID Card of the member.
  * @param option The type of attendance (BPHI, Committee, or Participant).
+ * @param record The verified record read from the card, or nullptr if the
+ *               card has none. A record identifies the member without a
+ *               server call.
  */
-void memberAttendance(String UID, PresenceOption option) {
-  Serial.println("Fetching member UID to database...");
-  TransmitterPort.println("Fetching member UID to database...");
-  delay(500);
+void memberAttendance(String UID, PresenceOption option,
+                      const CardRecord *record = nullptr) {
+  // Everything allocated from the tap arena is given back when this returns
+  ArenaScope tapScope(tapArena);
+
+#if DEBUG_ALL
+  static uint32_t tapCount = 0;
+  if (tapCount % HEAP_LOG_INTERVAL == 0) {
+    String label = "After " + String(tapCount) + " taps";
+    logHeapFragmentation(label.c_str());
+  }
+  tapCount++;
+#endif
 
-  // Check if member exists in PostmanAPI database
-  String *memberID = api.getMemberByUID("/api/mahasiswa", UID);
-  if (memberID == nullptr) {
-    Serial.printf("Member with UID %s isn't exists in member table!\n", UID);
+  // Answer duplicate taps from the attendance ledger of the running event,
+  // the event and the member lookups are only needed for members that
+  // haven't checked in yet
+  applyCurrentEvent();
+  if (attendanceLedger.contains(UID)) {
+    Serial.printf("Member with UID %s has already attended on event %s!\n",
+                  UID.c_str(), currentEvent.c_str());
     TransmitterPort.printf(
-        "Member with UID %s isn't exists in member table!</nl></nl>\n", UID);
+        "Member with UID %s has already attended on event %s!</nl></nl>\n",
+        UID.c_str(), currentEvent.c_str());
 
     display.clearDisplay();
     display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
-    display.setCursor(10, 60);
-    display.print("Invalid ID Data!");
+    display.setCursor(12, 60);
+    display.print("Already Log In!");
     display.display();
 
-    delay(1500);
     Serial.println();
     return;
   }
 
-  HashMap<String, String> optionColumn;
-  optionColumn.put("divisi", "presence_mode");
-  HashMap<String, String> logsData =
-      api.readData("/api/mahasiswa", UID, optionColumn);
+  // Copy the member out of the roster, a roster handle must not be held
+  // across server calls or it stalls every roster refresh
+  MemberRecord rosterMember;
+  bool isRosterMember = false;
+  uint32_t rosterVersion;
+  {
+    RosterHandle members = roster.acquire();
+    int memberSlot = members->findByUID(UID);
+    if (memberSlot >= 0) {
+      rosterMember = members->get(memberSlot);
+      isRosterMember = true;
+    }
+    rosterVersion = members.version();
+  }
+
+  // The signed card record already proves the member exists, the server
+  // still checks the UID when the attendance is logged
+  String presenceMode;
+  if (record != nullptr) {
+    Serial.printf("Member %u resolved from card record\n", record->memberId);
+    presenceMode = record->divisionName();
+  } else {
+    Serial.println("Fetching member UID to database...");
+    TransmitterPort.println("Fetching member UID to database...");
+
+    // Check if member exists in PostmanAPI database
+    String *memberID = api.getMemberByUID("/api/mahasiswa", UID);
+    if (memberID == nullptr) {
+      Serial.printf("Member with UID %s isn't exists in member table!\n", UID);
+      TransmitterPort.printf(
+          "Member with UID %s isn't exists in member table!</nl></nl>\n", UID);
+
+      display.clearDisplay();
+      display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
+      display.setCursor(10, 60);
+      display.print("Invalid ID Data!");
+      display.display();
+
+      Serial.println();
+      return;
+    }
+    delete memberID;
+
+    static constexpr Column optionColumn[] = {Column::DIVISI};
+    ColumnMap logsData = api.readData("/api/mahasiswa", UID, optionColumn);
+    presenceMode = logsData.get(Column::DIVISI);
+  }
 
-  String presenceMode = optionColumn.get("presence_mode");
   if (presenceMode.equalsIgnoreCase("BPHI")) {
     option = PresenceOption::BPHI;
   }
@@ -914,22 +1344,16 @@ void memberAttendance(String UID, PresenceOption option) {
     String formattedCurrDate = ntpClient.getFormattedDate();
     String currentDate = splitString(formattedCurrDate, 'T').get(0);
 
-    HashMap<String, String> logsColumn;
-    logsColumn.put("tanggal_masuk", "last_login");
-    HashMap<String, String> logsData =
-        api.readData("/api/mahasiswa", UID, logsColumn);
-
-    bool isLoggedIn = logsData.get("last_login") != nullptr;
+    bool isEventChanged = takeEventChanged();
+    static constexpr Column logsColumn[] = {Column::TANGGAL_MASUK};
+    ColumnMap logsData = api.readData("/api/mahasiswa", UID, logsColumn);
 
-    HashMap<String, String> eventsColumn;
-    eventsColumn.put("judul", "event_name");
-    HashMap<String, String> eventsData =
-        api.readData("/api/event", "", eventsColumn);
-    String eventName = eventsData.get("event_name");
+    bool isLoggedIn = logsData.get(Column::TANGGAL_MASUK) != nullptr;
 
-    // Check if member has already logged in for the current event today
-    if (isLoggedIn && eventName.equals(currentEvent)) {
-      String logInDateTime = logsData.get("last_login");
+    // Check if member has already logged in for the current event today,
+    // a log in of a previous event doesn't count
+    if (isLoggedIn && !isEventChanged) {
+      String logInDateTime = logsData.get(Column::TANGGAL_MASUK);
       String logInDate = splitString(logInDateTime, 'T').get(0);
 
       // Check if member has already attended today
@@ -943,47 +1367,41 @@ void memberAttendance(String UID, PresenceOption option) {
         display.setCursor(12, 60);
         display.print("Already Log In!");
         display.display();
+        attendanceLedger.mark(UID);
 
-        delay(1500);
         Serial.println();
         return;
-      } else if (!logInDate.equals(currentDate) &&
-                 eventName.equals(currentEvent)) {
+      } else if (!logInDate.equals(currentDate)) {
         Serial.printf("Member with UID %s has already attended on event %s!\n",
-                      UID, eventName.c_str());
+                      UID, currentEvent.c_str());
         TransmitterPort.printf(
             "Member with UID %s has already attended on event %s!</nl></nl>\n",
-            UID, eventName.c_str());
+            UID, currentEvent.c_str());
 
         display.clearDisplay();
         display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
         display.setCursor(12, 60);
         display.print("Already Log In!");
         display.display();
+        attendanceLedger.mark(UID);
 
-        delay(1500);
         Serial.println();
         return;
       }
     }
 
-    // Update current event name in preferences if changed
-    if (!eventName.equals(currentEvent)) {
-      pref.putString("event_name", eventName);
-      currentEvent = pref.getString("event_name");
-    }
+    FlatMap<Column, String, ArenaAllocator> attendanceData(tapArena);
+    COLLECTION_LABEL(attendanceData, "attendanceData");
+    attendanceData.put(Column::UID, UID);
+    attendanceData.put(Column::ROLE, getPresenceOption(option));
 
-    HashMap<String, String> attendanceData;
-    attendanceData.put("uid", UID);
-    attendanceData.put("role", getPresenceOption(option));
-
-    bool success = api.createData("/api/log/masuk", attendanceData.toJson());
+    bool success = api.createData("/api/log/masuk", attendanceData);
 
     if (success) {
+      attendanceLedger.mark(UID);
       Serial.println("Successfully wrote data to PostmanAPI Server!");
       TransmitterPort.println(
           "</nl>Successfully wrote data to PostmanAPI Server!");
-      delay(500);
       Serial.println();
       Serial.printf("Member with UID %s doing Log In attendance on %s!\n", UID,
                     currentDate);
@@ -996,7 +1414,12 @@ void memberAttendance(String UID, PresenceOption option) {
       display.setCursor(12, 60);
       display.print("Success Log In!");
       display.display();
-      delay(500);
+
+      // Seed the member cache from the roster, so the confirmation screen
+      // doesn't fetch the member again
+      syncMemberCache(rosterVersion);
+      if (isRosterMember && !memberCache.containsKey(UID))
+        memberCache.put(UID, rosterMember);
 
       showMemberData(UID);
     } else {
@@ -1016,7 +1439,6 @@ void memberAttendance(String UID, PresenceOption option) {
     TransmitterPort.println("Please check your internet connection.</nl>");
   }
 
-  delay(5000);
   Serial.println();
 }
 
@@ -1027,7 +1449,7 @@ void memberAttendance(String UID, PresenceOption option) {
  * saves the attendance data to the PostmanAPI Server.
  */
 void manualAttendance() {
-  HashMap<String, String> memberData;
+  ColumnMap memberData;
   char buffer[64]; // Buffer to hold input data
 
   String callbackData;
@@ -1058,13 +1480,25 @@ void manualAttendance() {
   Serial.print("Write Member Name: ");
   TransmitterPort.println("Write Member Name: ");
 
-  // Read until newline or buffer is full
-  readData = ReceiverPort.readBytesUntil('\n', buffer, sizeof(buffer) - 1);
-  buffer[readData] = '\0'; // Null-terminate C-string
+  while (true) {
+    buffer[0] = '\0'; // Clear buffer
 
-  // Convert to Arduino String
-  inputData = String(buffer);
-  inputData.trim();
+    // Read until newline or buffer is full
+    readData = ReceiverPort.readBytesUntil('\n', buffer, sizeof(buffer) - 1);
+    buffer[readData] = '\0'; // Null-terminate C-string
+
+    // Convert to Arduino String
+    inputData = String(buffer);
+    inputData.trim();
+
+    // Input ending with '?' is a partial name typed by the operator,
+    // answer it with name suggestions and keep waiting for the name
+    if (inputData.endsWith("?")) {
+      sendNameSuggestions(inputData.substring(0, inputData.length() - 1));
+      continue;
+    }
+    break;
+  }
 
   // If input is Cancel or no input is received, cancel the registration
   if (inputData.equals("")) {
@@ -1082,7 +1516,7 @@ void manualAttendance() {
 
   String namaAnggota = inputData;
   Serial.println(namaAnggota);
-  memberData.put("nama", namaAnggota);
+  memberData.put(Column::NAMA, namaAnggota);
   buffer[0] = '\0'; // clear buffer
 
   // ===================[ Prompt for NIM ]===================
@@ -1113,7 +1547,7 @@ void manualAttendance() {
 
   String nimAnggota = inputData;
   Serial.println(nimAnggota);
-  memberData.put("nim", nimAnggota);
+  memberData.put(Column::NIM, nimAnggota);
   buffer[0] = '\0'; // clear buffer
 
   // Save member attendance data to PostmanAPI database
@@ -1121,14 +1555,30 @@ void manualAttendance() {
   TransmitterPort.println("</nl>Write data to PostmanAPI database...");
   delay(500);
 
-  // Check if member exists in PostmanAPI database
-  String *memberCardUID = api.getMemberByName("/api/mahasiswa", namaAnggota);
+  // Check if member exists in the member index first, then fall back to
+  // the PostmanAPI database in case the member isn't cached yet
+  String *memberCardUID = nullptr;
+  {
+    // Only copy from the roster, the handle is released before any server
+    // call
+    RosterHandle members = roster.acquire();
+    int memberSlot = members->findByName(namaAnggota);
+    if (memberSlot >= 0) {
+      const MemberRecord &member = members->get(memberSlot);
+      memberCardUID = new String(member.uid);
+      memberData.update(Column::NAMA, member.name);
+    }
+  }
+  if (memberCardUID == nullptr)
+    memberCardUID = api.getMemberByName("/api/mahasiswa", namaAnggota);
+
   if (memberCardUID == nullptr) {
     Serial.printf("Member with name %s isn't exists in member table!\n",
                   namaAnggota.c_str());
     TransmitterPort.printf(
         "Member with name %s isn't exists in member table!</nl></nl>\n",
         namaAnggota.c_str());
+    sendNameSuggestions(namaAnggota);
 
     delay(1500);
     Serial.println();
@@ -1139,22 +1589,32 @@ void manualAttendance() {
     String formattedCurrDate = ntpClient.getFormattedDate();
     String currentDate = splitString(formattedCurrDate, 'T').get(0);
 
-    HashMap<String, String> logsColumn;
-    logsColumn.put("tanggal_masuk", "last_login");
-    HashMap<String, String> logsData =
-        api.readData("/api/mahasiswa", *memberCardUID, logsColumn);
+    // Answer duplicate check-ins from the attendance ledger of the running
+    // event
+    applyCurrentEvent();
+    if (attendanceLedger.contains(*memberCardUID)) {
+      Serial.printf("Member with UID %s has already attended on event %s!\n",
+                    memberCardUID->c_str(), currentEvent.c_str());
+      TransmitterPort.printf(
+          "Member with UID %s has already attended on event %s!</nl></nl>\n",
+          memberCardUID->c_str(), currentEvent.c_str());
+
+      delay(1500);
+      Serial.println();
+      return;
+    }
 
-    bool isLoggedIn = logsData.get("last_login") != nullptr;
+    bool isEventChanged = takeEventChanged();
+    static constexpr Column logsColumn[] = {Column::TANGGAL_MASUK};
+    ColumnMap logsData =
+        api.readData("/api/mahasiswa", *memberCardUID, logsColumn);
 
-    HashMap<String, String> eventsColumn;
-    eventsColumn.put("judul", "event_name");
-    HashMap<String, String> eventsData =
-        api.readData("/api/event", "", eventsColumn);
-    String eventName = eventsData.get("event_name");
+    bool isLoggedIn = logsData.get(Column::TANGGAL_MASUK) != nullptr;
 
-    // Check if member has already logged in for the current event today
-    if (isLoggedIn && eventName.equals(currentEvent)) {
-      String logInDateTime = logsData.get("last_login");
+    // Check if member has already logged in for the current event today,
+    // a log in of a previous event doesn't count
+    if (isLoggedIn && !isEventChanged) {
+      String logInDateTime = logsData.get(Column::TANGGAL_MASUK);
       String logInDate = splitString(logInDateTime, 'T').get(0);
 
       // Check if member has already attended today
@@ -1170,23 +1630,24 @@ void manualAttendance() {
         display.setCursor(12, 60);
         display.print("Already Log In!");
         display.display();
+        attendanceLedger.mark(*memberCardUID);
 
         delay(1500);
         Serial.println();
         return;
-      } else if (!logInDate.equals(currentDate) &&
-                 eventName.equals(currentEvent)) {
+      } else if (!logInDate.equals(currentDate)) {
         Serial.printf("Member with UID %s has already attended on event %s!\n",
-                      *memberCardUID, eventName.c_str());
+                      *memberCardUID, currentEvent.c_str());
         TransmitterPort.printf(
             "Member with UID %s has already attended on event %s!</nl></nl>\n",
-            *memberCardUID, eventName.c_str());
+            *memberCardUID, currentEvent.c_str());
 
         display.clearDisplay();
         display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
         display.setCursor(12, 60);
         display.print("Already Log In!");
         display.display();
+        attendanceLedger.mark(*memberCardUID);
 
         delay(1500);
         Serial.println();
@@ -1194,14 +1655,9 @@ void manualAttendance() {
       }
     }
 
-    // Update current event name in preferences if changed
-    if (!eventName.equals(currentEvent)) {
-      pref.putString("event_name", eventName);
-      currentEvent = pref.getString("event_name");
-    }
-
-    bool success = api.createData("/api/log/izin", memberData.toJson());
+    bool success = api.createData("/api/log/izin", memberData);
     if (success) {
+      attendanceLedger.mark(*memberCardUID);
       Serial.println("Successfully wrote data to PostmanAPI database!");
       TransmitterPort.println("Successfully wrote data to PostmanAPI Server!");
       delay(500);
@@ -1231,17 +1687,11 @@ void manualAttendance() {
 }
 
 /**
- * @brief Fetch the UID of the card.
- * This function checks if a card is present and reads its UID.
- * If a card is detected, it retrieves the UID and formats it as a string.
- *
- * @note The UID is returned as a pointer to a String object.
- * @return A pointer to a String containing the UID of the card.
+ * @brief Show that a card was detected.
+ * This function is called by the attendance task when it takes a tap from
+ * the tap queue, the reader task itself never touches the OLED.
  */
-String *getCardUID() {
-  if (!rfid.PICC_IsNewCardPresent() || !rfid.PICC_ReadCardSerial())
-    return nullptr;
-
+void showCardDetected() {
   Serial.println();
   Serial.println("**Card Detected!**");
   TransmitterPort.println("</nl>Card Detected!");
@@ -1250,21 +1700,6 @@ String *getCardUID() {
   display.setCursor(6, 60);
   display.print("ID Card Detected!");
   display.display();
-
-  // Get the UID of the card
-  String *memberUID = new String();
-  for (byte i = 0; i < rfid.uid.size; i++) {
-    *memberUID += rfid.uid.uidByte[i] < 0x10 ? " 0" : " ";
-    *memberUID += String(rfid.uid.uidByte[i], HEX);
-  }
-  memberUID->trim();
-  memberUID->toUpperCase();
-  delay(500);
-
-  // Stop reading the card
-  rfid.PICC_HaltA();
-  rfid.PCD_StopCrypto1();
-  return memberUID;
 }
 
 /**
@@ -1305,7 +1740,8 @@ void loop() {
 /**
  * @brief Handle displays a loading bar on the OLED screen.
  * This task will show a loading message with dots that
- * change every 500 milliseconds.
+ * change every 500 milliseconds. The screen is redrawn in full, but only
+ * the columns of the changed dots are sent to the OLED.
  *
  * @param pvParameters Pointer to the task parameters (not used).
  */
@@ -1393,6 +1829,31 @@ void TaskCheckConnection(void *pvParameters) {
   }
 }
 
+/**
+ * @brief Handle refreshing the member roster in the background.
+ * This task periodically downloads the member table with its own PostmanAPI
+ * instance and publishes it as a new roster snapshot. Taps keep resolving
+ * against the previous snapshot while the download is running. The running
+ * event is fetched with it, so taps pick up a new event without a server
+ * call.
+ *
+ * @param pvParameters Pointer to the task parameters (not used).
+ */
+void TaskRosterSync(void *pvParameters) {
+  (void)pvParameters;
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(ROSTER_SYNC_INTERVAL));
+
+    // Check if the system is disconnected
+    if (!WiFi.isConnected())
+      continue;
+
+    loadRoster(syncApi);
+    fetchCurrentEvent(syncApi);
+  }
+}
+
 /**
  * @brief Read data received from the Serial Monitor.
  * This function reads data from the ReceiverPort until a newline character
@@ -1457,6 +1918,9 @@ void TaskMain(void *pvParameters) {
         Serial.println("Opening attendance member data...");
         delay(500);
 
+        // Fetch the running event before the first tap, the attendance
+        // task is suspended and doesn't use the PostmanAPI instance
+        fetchCurrentEvent(api);
         mainMenuOption = MainMenuOption::ATTENDANCE;
         vTaskResume(
             taskAttendanceHandler); // Resume the attendance handler task
@@ -1538,6 +2002,14 @@ void TaskRegister(void *pvParameters) {
 void TaskAttendance(void *pvParameters) {
   (void)pvParameters;
 
+  // The tap prompt is drawn once and stays on the OLED until a card or a
+  // menu option replaces it
+  bool showTapPrompt = true;
+  // The result of the last tap stays on the OLED until the next tap or
+  // RESULT_SCREEN_TIMEOUT, the task doesn't wait for it
+  bool isResultShown = false;
+  uint32_t resultShownAt = 0;
+
   for (;;) {
     // Check if the system is disconnected
     if (!WiFi.isConnected() || mainMenuOption != MainMenuOption::ATTENDANCE) {
@@ -1545,8 +2017,19 @@ void TaskAttendance(void *pvParameters) {
       continue;
     }
 
-    receivedData = readReceivedData();
+    // Only read when a line arrived, so waiting for a card isn't delayed
+    // by the serial read timeout
+    receivedData = ReceiverPort.available() ? readReceivedData() : "";
+#if TAP_REPLAY_MODE
+    // Lines of a replay script start with "TAP", the others are menu options
+    while (receivedData.startsWith("TAP ")) {
+      replaySource.schedule(receivedData.c_str() + 4);
+      receivedData = ReceiverPort.available() ? readReceivedData() : "";
+    }
+#endif
     if (receivedData != "") {
+      showTapPrompt = true;
+      isResultShown = false;
 #if DEBUG_ALL
       Serial.println(receivedData);
 #endif
@@ -1571,6 +2054,7 @@ void TaskAttendance(void *pvParameters) {
         Serial.println("Manual attendance member...");
         TransmitterPort.println("</nl>Manual attendance member...");
         manualAttendance();
+        attendanceLedger.flush();
 
         String callbackData;
         JsonDocument callbackDoc;
@@ -1595,6 +2079,11 @@ void TaskAttendance(void *pvParameters) {
         mainMenuOption = MainMenuOption::MAIN_MENU;
         presenceOption = PresenceOption::NONE;
 
+        // Drop the taps that weren't processed before leaving
+        for (TapEvent stale; tapQueue.pop(stale);) {
+        }
+        attendanceLedger.flush();
+
         vTaskResume(taskMainHandler); // Resume the main handler task
         vTaskSuspend(NULL);           // Suspend this task
         break;
@@ -1603,28 +2092,118 @@ void TaskAttendance(void *pvParameters) {
       }
     }
 
-    if (presenceOption != PresenceOption::NONE) {
-      String *uid = getCardUID(); // Get the UID of the card
+    if (presenceOption == PresenceOption::NONE) {
+      vTaskDelay(pdMS_TO_TICKS(500));
+      continue;
+    }
 
-      // Check if the member UID card is valid
-      if (uid != nullptr) {
-        String memberUID = *uid;
-        memberAttendance(memberUID, presenceOption);
+    if (showTapPrompt) {
+      Serial.println("Please put member id card into RFID Reader...");
+      TransmitterPort.println("Please put member id card into RFID Reader...");
 
-        delete uid;
-        uid = nullptr;
-      } else {
-        Serial.println("Please put member id card into RFID Reader...");
-        TransmitterPort.println(
-            "Please put member id card into RFID Reader...");
+      display.clearDisplay();
+      display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
+      display.setCursor(6, 60);
+      display.print("Tap Your ID Card!");
+      display.display();
+      showTapPrompt = false;
+    }
 
-        display.clearDisplay();
-        display.drawBitmap(32, 0, cardBitmap, 68, 50, SSD1306_WHITE);
-        display.setCursor(6, 60);
-        display.print("Tap Your ID Card!");
-        display.display();
+    TapEvent event;
+    if (!tapQueue.pop(event)) {
+      if (isResultShown && millis() - resultShownAt >= RESULT_SCREEN_TIMEOUT) {
+        isResultShown = false;
+        showTapPrompt = true;
       }
+
+      // Persist the check-ins of the last burst of taps while idle
+      attendanceLedger.flush();
+
+      // Sleep until the reader task queues a tap, the wait replaces the
+      // task delay
+#if TAP_REPLAY_MODE
+      // No tap was queued for a whole wait, so every tap the reader task
+      // took from the replay has been processed
+      if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CARD_WAIT_TIMEOUT)) == 0 &&
+          replaySource.takeFinished())
+        printReplayReport();
+#else
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CARD_WAIT_TIMEOUT));
+#endif
+      continue;
     }
-    vTaskDelay(pdMS_TO_TICKS(500));
+
+    showCardDetected();
+#if DEBUG_ALL
+    Serial.printf("Tap queued %u ms ago, %u waiting, %u dropped\n",
+                  millis() - event.tappedAt, tapQueue.size(),
+                  droppedTaps.load());
+#endif
+
+    // Only a record signed by this kiosk for this card identifies the member
+    CardRecord record;
+    bool isVerified = event.hasRecord &&
+                      cardSigner.decode(event.record, event.uid, record);
+    memberAttendance(event.uid.toString(), presenceOption,
+                     isVerified ? &record : nullptr);
+#if TAP_REPLAY_MODE
+    tapLatency.record(millis() - event.tappedAt);
+#endif
+    isResultShown = true;
+    resultShownAt = millis();
+  }
+}
+
+/**
+ * @brief Handle reading member cards.
+ * This high priority task only scans the RFID reader while the attendance
+ * menu is waiting for cards. Each pass reads every card in the field, and
+ * every card read is checked against the tap debouncer and pushed into the
+ * tap queue with its read time, so taps keep being read while the
+ * attendance task is busy with a request. The attendance task is notified
+ * after every pass that queued a tap.
+ *
+ * @param pvParameters Pointer to the task parameters (not used).
+ */
+void TaskCardReader(void *pvParameters) {
+  (void)pvParameters;
+
+  for (;;) {
+    // Only scan for the attendance menu, the register menu reads the
+    // reader itself
+    if (mainMenuOption != MainMenuOption::ATTENDANCE ||
+        presenceOption == PresenceOption::NONE) {
+      vTaskDelay(pdMS_TO_TICKS(200));
+      continue;
+    }
+
+    // Read every card in the field, so members who hold their cards to
+    // the reader together are all queued in one pass
+    TapEvent cards[CARD_INVENTORY_SIZE];
+    size_t cardCount = 0;
+    {
+      SemaphoreGuard guard(rfidLock);
+      if (tapSource.waitForCard(CARD_WAIT_TIMEOUT))
+        cardCount = tapSource.readCards(cards, CARD_INVENTORY_SIZE);
+    }
+
+    uint32_t tappedAt = millis();
+    bool isQueued = false;
+    for (size_t i = 0; i < cardCount; i++) {
+      if (!tapDebouncer.accept(cards[i].uid, tappedAt)) {
+        debouncedTaps++;
+        continue;
+      }
+
+      cards[i].tappedAt = tappedAt;
+      if (tapQueue.push(cards[i])) {
+        isQueued = true;
+      } else {
+        droppedTaps++;
+      }
+    }
+
+    if (isQueued)
+      xTaskNotifyGive(taskAttendanceHandler); // Wake the attendance task
   }
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef ALLOCATION_COUNTER_SHIM_H
+#define ALLOCATION_COUNTER_SHIM_H
+
+// Replaces the global operator new with one that counts its calls, so a
+// test can measure the heap allocations of a workload. Include it from a
+// single file of a test, the replacement must only be defined once.
+
+#include <new>
+#include <stdlib.h>
+
+// Allocations made through operator new, reset by the test as it needs
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+  allocations++;
+  void *ptr = malloc(size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+/**
+ * @brief Counts the heap allocations of a workload.
+ *
+ * @param workload The workload to run.
+ * @return The number of allocations it made.
+ */
+template <typename Workload> size_t countAllocations(Workload workload) {
+  size_t before = allocations;
+  workload();
+  return allocations - before;
+}
+
+#endif
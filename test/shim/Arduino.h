@@ -0,0 +1,323 @@
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+// A minimal stand-in for the Arduino core, used by the native test
+// environment. It only covers what the headers under test use: String,
+// Print, Stream, the timing functions and a Serial that writes to stdout.
+
+#include <algorithm>
+#include <chrono>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <strings.h>
+#include <thread>
+
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+
+/**
+ * @brief A host version of the Arduino String.
+ * The characters are kept in a std::string, so the String allocates like
+ * the Arduino one does: on construction from text and when it grows.
+ */
+class String {
+  private:
+  std::string text;
+
+  /**
+   * @brief Formats an integer in the given base.
+   *
+   * @param value The integer to format.
+   * @param isNegative Whether the integer is negative.
+   * @param base The base, 10 or 16.
+   */
+  void assignNumber(unsigned long long value, bool isNegative, int base) {
+    char digits[24];
+    size_t length = 0;
+    do {
+      digits[length++] = "0123456789abcdef"[value % base];
+      value /= base;
+    } while (value > 0);
+
+    if (isNegative)
+      text += '-';
+    while (length > 0)
+      text += digits[--length];
+  }
+
+  public:
+  String() {}
+  String(const char *value) : text(value != nullptr ? value : "") {}
+  String(const char *value, size_t length) : text(value, length) {}
+  String(char value) : text(1, value) {}
+  String(int value, unsigned char base = DEC) {
+    assignNumber(value < 0 ? -(long long)value : value, value < 0, base);
+  }
+  String(long value, unsigned char base = DEC) {
+    assignNumber(value < 0 ? -(long long)value : value, value < 0, base);
+  }
+  String(unsigned char value, unsigned char base = DEC) {
+    assignNumber(value, false, base);
+  }
+  String(unsigned int value, unsigned char base = DEC) {
+    assignNumber(value, false, base);
+  }
+  String(unsigned long value, unsigned char base = DEC) {
+    assignNumber(value, false, base);
+  }
+
+  const char *c_str() const { return text.c_str(); }
+  unsigned int length() const { return text.size(); }
+  bool reserve(unsigned int size) {
+    text.reserve(size);
+    return true;
+  }
+
+  char operator[](unsigned int index) const { return text[index]; }
+  char &operator[](unsigned int index) { return text[index]; }
+
+  String &operator+=(const String &other) {
+    text += other.text;
+    return *this;
+  }
+  String &operator+=(const char *other) {
+    text += other;
+    return *this;
+  }
+  String &operator+=(char other) {
+    text += other;
+    return *this;
+  }
+  bool concat(const char *value, unsigned int length) {
+    text.append(value, length);
+    return true;
+  }
+
+  friend String operator+(const String &a, const String &b) {
+    String result(a);
+    result += b;
+    return result;
+  }
+  friend String operator+(const String &a, const char *b) {
+    String result(a);
+    result += b;
+    return result;
+  }
+  friend String operator+(const char *a, const String &b) {
+    String result(a);
+    result += b;
+    return result;
+  }
+
+  bool operator==(const String &other) const { return text == other.text; }
+  bool operator!=(const String &other) const { return text != other.text; }
+  bool operator==(const char *other) const { return text == other; }
+  bool operator!=(const char *other) const { return text != other; }
+  bool operator<(const String &other) const { return text < other.text; }
+  bool equals(const String &other) const { return text == other.text; }
+  bool equalsIgnoreCase(const String &other) const {
+    return strcasecmp(c_str(), other.c_str()) == 0;
+  }
+  int compareTo(const String &other) const { return text.compare(other.text); }
+
+  bool startsWith(const String &prefix) const {
+    return text.compare(0, prefix.text.size(), prefix.text) == 0;
+  }
+  bool endsWith(const String &suffix) const {
+    return text.size() >= suffix.text.size() &&
+           text.compare(text.size() - suffix.text.size(), suffix.text.size(),
+                        suffix.text) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t found = text.find(c, from);
+    return found == std::string::npos ? -1 : (int)found;
+  }
+  int indexOf(const String &other, unsigned int from = 0) const {
+    size_t found = text.find(other.text, from);
+    return found == std::string::npos ? -1 : (int)found;
+  }
+  String substring(unsigned int from) const {
+    return from < text.size() ? String(text.c_str() + from) : String();
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from >= text.size() || to <= from)
+      return String();
+    size_t end = std::min<size_t>(to, text.size());
+    return String(text.c_str() + from, end - from);
+  }
+
+  void trim() {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+      text.clear();
+      return;
+    }
+    size_t last = text.find_last_not_of(" \t\r\n");
+    text = text.substr(first, last - first + 1);
+  }
+  void toUpperCase() {
+    for (char &c : text)
+      c = toupper((unsigned char)c);
+  }
+  void toLowerCase() {
+    for (char &c : text)
+      c = tolower((unsigned char)c);
+  }
+  long toInt() const { return atol(text.c_str()); }
+};
+
+/**
+ * @brief A host version of the Arduino Print.
+ * Subclasses only implement the single byte write, the other writes and the
+ * print functions are built on it.
+ */
+class Print {
+  public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+    while (size-- > 0)
+      written += write(*buffer++);
+    return written;
+  }
+  size_t write(const char *text) {
+    return text != nullptr ? write((const uint8_t *)text, strlen(text)) : 0;
+  }
+  size_t write(const char *buffer, size_t size) {
+    return write((const uint8_t *)buffer, size);
+  }
+
+  size_t print(const String &value) {
+    return write((const uint8_t *)value.c_str(), value.length());
+  }
+  size_t print(const char *value) { return write(value); }
+  size_t print(char value) { return write((uint8_t)value); }
+  size_t print(unsigned char value, int base = DEC) {
+    return print(String(value, base));
+  }
+  size_t print(int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned int value, int base = DEC) {
+    return print(String(value, base));
+  }
+  size_t print(long value, int base = DEC) {
+    return print(String(value, base));
+  }
+  size_t print(unsigned long value, int base = DEC) {
+    return print(String(value, base));
+  }
+  size_t print(double value, int digits = 2) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T &value) {
+    size_t written = print(value);
+    return written + println();
+  }
+
+  size_t printf(const char *format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return length > 0 ? print(text) : 0;
+  }
+};
+
+/**
+ * @brief A host version of the Arduino Stream.
+ * Reads never wait: a read that finds no byte ends at once, as if the
+ * timeout had passed.
+ */
+class Stream : public Print {
+  public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long) {}
+
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0)
+        break;
+      buffer[count++] = c;
+    }
+    return count;
+  }
+
+  size_t readBytesUntil(char terminator, char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0 || c == terminator)
+        break;
+      buffer[count++] = c;
+    }
+    return count;
+  }
+};
+
+/**
+ * @brief A Serial port that writes to the standard output.
+ */
+class HostSerial : public Stream {
+  public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+inline HostSerial Serial;
+
+/**
+ * @brief Gets the time since the program started.
+ *
+ * @return The time in milliseconds.
+ */
+inline unsigned long millis() {
+  static const auto started = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - started)
+      .count();
+}
+
+/**
+ * @brief Gets the time since the program started.
+ *
+ * @return The time in microseconds.
+ */
+inline unsigned long micros() {
+  static const auto started = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - started)
+      .count();
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline bool isDigit(char c) { return isdigit((unsigned char)c) != 0; }
+inline bool isHexadecimalDigit(char c) {
+  return isxdigit((unsigned char)c) != 0;
+}
+inline bool isSpace(char c) { return isspace((unsigned char)c) != 0; }
+
+#endif
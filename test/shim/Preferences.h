@@ -0,0 +1,67 @@
+#ifndef PREFERENCES_SHIM_H
+#define PREFERENCES_SHIM_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A host version of the Preferences library of the ESP32 core.
+ * The keys live in memory for the lifetime of the object, which is enough
+ * to check what the code under test stores and reads back. Every write is
+ * counted, so a test can check how often the flash would be written.
+ */
+class Preferences {
+  private:
+  std::map<std::string, std::vector<uint8_t>> entries;
+
+  public:
+  // Number of put calls, each one a flash write on the device
+  size_t writes = 0;
+
+  bool begin(const char *name, bool readOnly = false) { return true; }
+  void end() {}
+
+  bool clear() {
+    entries.clear();
+    return true;
+  }
+
+  bool isKey(const char *key) { return entries.count(key) > 0; }
+
+  bool remove(const char *key) { return entries.erase(key) > 0; }
+
+  size_t putBytes(const char *key, const void *value, size_t length) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(value);
+    entries[key].assign(bytes, bytes + length);
+    writes++;
+    return length;
+  }
+
+  size_t getBytesLength(const char *key) {
+    auto found = entries.find(key);
+    return found == entries.end() ? 0 : found->second.size();
+  }
+
+  size_t getBytes(const char *key, void *buffer, size_t length) {
+    auto found = entries.find(key);
+    if (found == entries.end() || found->second.size() > length)
+      return 0;
+    memcpy(buffer, found->second.data(), found->second.size());
+    return found->second.size();
+  }
+
+  size_t putString(const char *key, const String &value) {
+    return putBytes(key, value.c_str(), value.length());
+  }
+
+  String getString(const char *key, const String &defaultValue = String()) {
+    auto found = entries.find(key);
+    if (found == entries.end())
+      return defaultValue;
+    return String((const char *)found->second.data(), found->second.size());
+  }
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef STREAMSTRING_SHIM_H
+#define STREAMSTRING_SHIM_H
+
+#include <Arduino.h>
+
+/**
+ * @brief A host version of the StreamString of the ESP32 core.
+ * Bytes written to it are appended to the String, and reads consume the
+ * String from the front, so a test can capture the output of a Print or
+ * feed a Stream from text.
+ */
+class StreamString : public Stream, public String {
+  private:
+  // Position of the next byte to read
+  size_t position = 0;
+
+  public:
+  StreamString() {}
+  StreamString(const char *text) : String(text) {}
+
+  size_t write(uint8_t c) override {
+    *this += (char)c;
+    return 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override {
+    concat((const char *)buffer, size);
+    return size;
+  }
+
+  int available() override { return length() - position; }
+
+  int read() override {
+    int c = peek();
+    if (c >= 0)
+      position++;
+    return c;
+  }
+
+  int peek() override {
+    return position < length() ? (uint8_t)(*this)[position] : -1;
+  }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef TRACKED_SHIM_H
+#define TRACKED_SHIM_H
+
+#include <stddef.h>
+
+/**
+ * @brief A value that counts how often it is copied.
+ * Moves aren't counted, so a test can check that a collection moves its
+ * items instead of copying them.
+ */
+struct Tracked {
+  static inline size_t copies = 0;
+  int value = 0;
+
+  Tracked() {}
+  Tracked(int value) : value(value) {}
+  Tracked(const Tracked &other) : value(other.value) { copies++; }
+  Tracked(Tracked &&other) : value(other.value) {}
+  Tracked &operator=(const Tracked &other) {
+    value = other.value;
+    copies++;
+    return *this;
+  }
+  Tracked &operator=(Tracked &&other) {
+    value = other.value;
+    return *this;
+  }
+  bool operator==(const Tracked &other) const { return value == other.value; }
+};
+
+#endif
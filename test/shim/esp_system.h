@@ -0,0 +1,19 @@
+#ifndef ESP_SYSTEM_SHIM_H
+#define ESP_SYSTEM_SHIM_H
+
+// A host version of the ESP-IDF system API, covering the random number
+// generator only.
+
+#include <random>
+#include <stddef.h>
+#include <stdint.h>
+
+inline void esp_fill_random(void *buffer, size_t length) {
+  static std::random_device device;
+  uint8_t *bytes = static_cast<uint8_t *>(buffer);
+  for (size_t i = 0; i < length; i++) {
+    bytes[i] = device();
+  }
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef FREERTOS_SHIM_H
+#define FREERTOS_SHIM_H
+
+// A host version of the FreeRTOS base types, with one tick per millisecond
+// like the ESP32 Arduino core.
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SEMPHR_SHIM_H
+#define SEMPHR_SHIM_H
+
+// A host version of the FreeRTOS semaphores, covering the statically
+// allocated mutexes and binary semaphores. Threads stand in for tasks.
+
+#include <chrono>
+#include <condition_variable>
+#include <freertos/FreeRTOS.h>
+#include <mutex>
+
+/**
+ * @brief The storage of a semaphore that holds at most one token.
+ */
+struct StaticSemaphore_t {
+  std::mutex lock;
+  std::condition_variable given;
+  bool hasToken = false;
+};
+
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(
+    StaticSemaphore_t *buffer) {
+  buffer->hasToken = true;
+  return buffer;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(
+    StaticSemaphore_t *buffer) {
+  buffer->hasToken = false;
+  return buffer;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore,
+                                 TickType_t ticks) {
+  std::unique_lock<std::mutex> guard(semaphore->lock);
+  auto hasToken = [semaphore] { return semaphore->hasToken; };
+  if (ticks == portMAX_DELAY) {
+    semaphore->given.wait(guard, hasToken);
+  } else if (!semaphore->given.wait_for(
+                 guard, std::chrono::milliseconds(ticks), hasToken)) {
+    return pdFALSE;
+  }
+  semaphore->hasToken = false;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  {
+    std::lock_guard<std::mutex> guard(semaphore->lock);
+    if (semaphore->hasToken)
+      return pdFALSE;
+    semaphore->hasToken = true;
+  }
+  semaphore->given.notify_one();
+  return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) {}
+
+#endif
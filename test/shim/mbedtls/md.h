@@ -0,0 +1,213 @@
+#ifndef MBEDTLS_MD_SHIM_H
+#define MBEDTLS_MD_SHIM_H
+
+// A host version of the mbedTLS message digest API, covering only the
+// HMAC-SHA256 calls the card records use. The digest is computed here, so
+// the tests check the real tags the firmware writes.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum { MBEDTLS_MD_NONE = 0, MBEDTLS_MD_SHA256 = 6 } mbedtls_md_type_t;
+
+typedef struct {
+  mbedtls_md_type_t type;
+} mbedtls_md_info_t;
+
+// Size of a SHA-256 block and digest in bytes
+#define SHIM_SHA256_BLOCK 64
+#define SHIM_SHA256_DIGEST 32
+
+/**
+ * @brief The running state of a SHA-256 hash.
+ */
+typedef struct {
+  uint32_t state[8];
+  uint8_t buffer[SHIM_SHA256_BLOCK];
+  size_t buffered;
+  uint64_t length;
+} shim_sha256_t;
+
+typedef struct {
+  const mbedtls_md_info_t *info;
+  shim_sha256_t inner;
+  // Key padded to a block and masked with the outer pad
+  uint8_t outerKey[SHIM_SHA256_BLOCK];
+} mbedtls_md_context_t;
+
+inline uint32_t shim_sha256_rotate(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+/**
+ * @brief Hashes one 64 byte block into the state.
+ */
+inline void shim_sha256_block(shim_sha256_t *hash, const uint8_t *block) {
+  static const uint32_t K[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+           (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+  }
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = shim_sha256_rotate(w[i - 15], 7) ^
+                  shim_sha256_rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = shim_sha256_rotate(w[i - 2], 17) ^
+                  shim_sha256_rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t v[8];
+  memcpy(v, hash->state, sizeof(v));
+  for (int i = 0; i < 64; i++) {
+    uint32_t s1 = shim_sha256_rotate(v[4], 6) ^ shim_sha256_rotate(v[4], 11) ^
+                  shim_sha256_rotate(v[4], 25);
+    uint32_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+    uint32_t t1 = v[7] + s1 + choice + K[i] + w[i];
+    uint32_t s0 = shim_sha256_rotate(v[0], 2) ^ shim_sha256_rotate(v[0], 13) ^
+                  shim_sha256_rotate(v[0], 22);
+    uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+    memmove(v + 1, v, 7 * sizeof(uint32_t));
+    v[4] += t1;
+    v[0] = t1 + s0 + majority;
+  }
+  for (int i = 0; i < 8; i++) {
+    hash->state[i] += v[i];
+  }
+}
+
+inline void shim_sha256_start(shim_sha256_t *hash) {
+  static const uint32_t INITIAL[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                      0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                      0x1f83d9ab, 0x5be0cd19};
+  memcpy(hash->state, INITIAL, sizeof(INITIAL));
+  hash->buffered = 0;
+  hash->length = 0;
+}
+
+inline void shim_sha256_update(shim_sha256_t *hash, const uint8_t *data,
+                               size_t size) {
+  hash->length += size;
+  while (size > 0) {
+    size_t taken = SHIM_SHA256_BLOCK - hash->buffered;
+    if (taken > size)
+      taken = size;
+    memcpy(hash->buffer + hash->buffered, data, taken);
+    hash->buffered += taken;
+    data += taken;
+    size -= taken;
+
+    if (hash->buffered == SHIM_SHA256_BLOCK) {
+      shim_sha256_block(hash, hash->buffer);
+      hash->buffered = 0;
+    }
+  }
+}
+
+inline void shim_sha256_finish(shim_sha256_t *hash, uint8_t *digest) {
+  uint64_t bits = hash->length * 8;
+  uint8_t pad = 0x80;
+  shim_sha256_update(hash, &pad, 1);
+  pad = 0;
+  while (hash->buffered != SHIM_SHA256_BLOCK - 8) {
+    shim_sha256_update(hash, &pad, 1);
+  }
+  uint8_t length[8];
+  for (int i = 0; i < 8; i++) {
+    length[i] = bits >> (56 - 8 * i);
+  }
+  shim_sha256_update(hash, length, 8);
+
+  for (int i = 0; i < 8; i++) {
+    digest[i * 4] = hash->state[i] >> 24;
+    digest[i * 4 + 1] = hash->state[i] >> 16;
+    digest[i * 4 + 2] = hash->state[i] >> 8;
+    digest[i * 4 + 3] = hash->state[i];
+  }
+}
+
+inline const mbedtls_md_info_t *mbedtls_md_info_from_type(
+    mbedtls_md_type_t type) {
+  static const mbedtls_md_info_t SHA256_INFO = {MBEDTLS_MD_SHA256};
+  return type == MBEDTLS_MD_SHA256 ? &SHA256_INFO : nullptr;
+}
+
+inline void mbedtls_md_init(mbedtls_md_context_t *context) {
+  memset(context, 0, sizeof(*context));
+}
+
+inline int mbedtls_md_setup(mbedtls_md_context_t *context,
+                            const mbedtls_md_info_t *info, int hmac) {
+  if (info == nullptr || !hmac)
+    return -1;
+  context->info = info;
+  return 0;
+}
+
+inline int mbedtls_md_hmac_starts(mbedtls_md_context_t *context,
+                                  const unsigned char *key, size_t keyLength) {
+  if (context->info == nullptr)
+    return -1;
+
+  uint8_t block[SHIM_SHA256_BLOCK] = {};
+  if (keyLength > SHIM_SHA256_BLOCK) {
+    shim_sha256_t hash;
+    shim_sha256_start(&hash);
+    shim_sha256_update(&hash, key, keyLength);
+    shim_sha256_finish(&hash, block);
+  } else {
+    memcpy(block, key, keyLength);
+  }
+
+  uint8_t innerKey[SHIM_SHA256_BLOCK];
+  for (int i = 0; i < SHIM_SHA256_BLOCK; i++) {
+    innerKey[i] = block[i] ^ 0x36;
+    context->outerKey[i] = block[i] ^ 0x5c;
+  }
+  shim_sha256_start(&context->inner);
+  shim_sha256_update(&context->inner, innerKey, SHIM_SHA256_BLOCK);
+  return 0;
+}
+
+inline int mbedtls_md_hmac_update(mbedtls_md_context_t *context,
+                                  const unsigned char *input, size_t length) {
+  if (context->info == nullptr)
+    return -1;
+  shim_sha256_update(&context->inner, input, length);
+  return 0;
+}
+
+inline int mbedtls_md_hmac_finish(mbedtls_md_context_t *context,
+                                  unsigned char *output) {
+  if (context->info == nullptr)
+    return -1;
+
+  uint8_t innerDigest[SHIM_SHA256_DIGEST];
+  shim_sha256_finish(&context->inner, innerDigest);
+
+  shim_sha256_t outer;
+  shim_sha256_start(&outer);
+  shim_sha256_update(&outer, context->outerKey, SHIM_SHA256_BLOCK);
+  shim_sha256_update(&outer, innerDigest, SHIM_SHA256_DIGEST);
+  shim_sha256_finish(&outer, output);
+  return 0;
+}
+
+inline void mbedtls_md_free(mbedtls_md_context_t *context) {
+  memset(context, 0, sizeof(*context));
+}
+
+#endif
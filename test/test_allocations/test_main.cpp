@@ -0,0 +1,124 @@
+#include <AllocationCounter.h>
+#include <Columns.h>
+#include <SplitString.h>
+#include <stdio.h>
+#include <unity.h>
+
+// Values long enough to be allocated, short text fits inside a String
+static const char *const LOG_DATE_TIME = "2025-05-01T08:30:00.123456+00:00";
+static const char *const MEMBER_NAME = "Budi Santoso Wijaya Kusuma";
+static const char *const MEMBER_DIVISION = "Kelembagaan dan Organisasi";
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Builds a column map the way PostmanAPI::readColumns does, one
+ * value per column taken out of the response.
+ *
+ * @param columns The columns to read.
+ * @param values The response values of the columns.
+ * @param count The number of columns.
+ * @return The map of the columns.
+ */
+ColumnMap readColumns(const Column *columns, const char *const *values,
+                      size_t count) {
+  ColumnMap data;
+  data.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    String columnValue = values[i];
+    data.put(columns[i], std::move(columnValue));
+  }
+  return data;
+}
+
+/**
+ * @brief Reports the allocations of a workload next to the ones of its
+ * values alone.
+ */
+void report(const char *workload, size_t count, size_t values) {
+  char line[120];
+  snprintf(line, sizeof(line), "%-12s %zu allocations, %zu for the values",
+           workload, count, values);
+  TEST_MESSAGE(line);
+}
+
+void test_split_only_allocates_the_parts() {
+  String dateTime = LOG_DATE_TIME;
+
+  // The parts themselves are the only allocations a split can't avoid
+  size_t parts = countAllocations([&dateTime] {
+    String date = dateTime.substring(0, 10);
+    String time = dateTime.substring(11);
+  });
+  size_t split = countAllocations([&dateTime] {
+    auto result = splitString(dateTime, 'T');
+    TEST_ASSERT_EQUAL(2, result.size());
+    TEST_ASSERT_EQUAL_STRING("2025-05-01", result.get(0).c_str());
+  });
+
+  report("split", split, parts);
+  TEST_ASSERT_EQUAL(parts, split);
+}
+
+void test_read_data_only_allocates_the_values() {
+  static constexpr Column columns[] = {Column::NAMA, Column::DIVISI,
+                                       Column::TANGGAL_MASUK};
+  const char *const values[] = {MEMBER_NAME, MEMBER_DIVISION, LOG_DATE_TIME};
+
+  size_t strings = countAllocations([&values] {
+    for (const char *value : values) {
+      String copy = value;
+    }
+  });
+  TEST_ASSERT_GREATER_THAN(0, strings);
+
+  // The pooled arrays and the moves out of the map add nothing
+  size_t read = countAllocations([&values] {
+    ColumnMap data = readColumns(columns, values, 3);
+    ColumnMap moved = std::move(data);
+    TEST_ASSERT_EQUAL_STRING(MEMBER_NAME, moved.find(Column::NAMA)->c_str());
+  });
+  report("readData", read, strings);
+  TEST_ASSERT_EQUAL(strings, read);
+
+  // A copy of the map copies every value, which the moves avoid
+  ColumnMap data = readColumns(columns, values, 3);
+  size_t copied = countAllocations([&data] { ColumnMap copy = data; });
+  TEST_ASSERT_EQUAL(strings, copied);
+}
+
+void test_split_and_map() {
+  static constexpr Column columns[] = {Column::NAMA, Column::DIVISI,
+                                       Column::TANGGAL_MASUK};
+  String line = String(MEMBER_NAME) + ";" + MEMBER_DIVISION + ";" +
+                LOG_DATE_TIME;
+
+  size_t strings = countAllocations([] {
+    String name = MEMBER_NAME;
+    String division = MEMBER_DIVISION;
+    String dateTime = LOG_DATE_TIME;
+  });
+
+  // The split parts move into the map, so the row only allocates its values
+  size_t mapped = countAllocations([&line] {
+    auto parts = splitString(line, ';');
+    ColumnMap row;
+    for (size_t i = 0; i < parts.size(); i++) {
+      row.put(columns[i], std::move(parts.get(i)));
+    }
+    TEST_ASSERT_EQUAL_STRING(MEMBER_DIVISION,
+                             row.find(Column::DIVISI)->c_str());
+  });
+
+  report("split+map", mapped, strings);
+  TEST_ASSERT_EQUAL(strings, mapped);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_split_only_allocates_the_parts);
+  RUN_TEST(test_read_data_only_allocates_the_values);
+  RUN_TEST(test_split_and_map);
+  return UNITY_END();
+}
@@ -0,0 +1,164 @@
+#include <Allocator.h>
+#include <ArrayList.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Fills a block with a run of bytes starting at a value.
+ */
+void fill(void *ptr, size_t size, uint8_t first) {
+  uint8_t *bytes = static_cast<uint8_t *>(ptr);
+  for (size_t i = 0; i < size; i++) {
+    bytes[i] = first + i;
+  }
+}
+
+/**
+ * @brief Checks that a block starts with a run written by fill.
+ */
+void assertFilled(const void *ptr, size_t size, uint8_t first) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(ptr);
+  for (size_t i = 0; i < size; i++) {
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(first + i), bytes[i]);
+  }
+}
+
+void test_pool_falls_back_to_heap_when_empty() {
+  FixedBlockPool<32, 2> pool;
+  void *first = pool.allocate(32);
+  void *second = pool.allocate(16);
+  TEST_ASSERT_TRUE(pool.owns(first));
+  TEST_ASSERT_TRUE(pool.owns(second));
+  TEST_ASSERT_EQUAL(2, pool.getUsed());
+
+  // The pool is empty, the next block comes from the heap
+  void *third = pool.allocate(8);
+  TEST_ASSERT_FALSE(pool.owns(third));
+  TEST_ASSERT_EQUAL(1, pool.getFallbacks());
+
+  // A block larger than the pool's blocks isn't counted as a fallback
+  void *large = pool.allocate(64);
+  TEST_ASSERT_FALSE(pool.owns(large));
+  TEST_ASSERT_EQUAL(1, pool.getFallbacks());
+
+  pool.deallocate(third, 8);
+  pool.deallocate(large, 64);
+  pool.deallocate(first, 32);
+  TEST_ASSERT_EQUAL(1, pool.getUsed());
+
+  // A returned block is handed out again
+  void *again = pool.allocate(24);
+  TEST_ASSERT_EQUAL_PTR(first, again);
+  pool.deallocate(again, 24);
+  pool.deallocate(second, 16);
+  TEST_ASSERT_EQUAL(0, pool.getUsed());
+}
+
+void test_pool_reallocates_across_block_size() {
+  FixedBlockPool<32, 2> pool;
+  void *block = pool.allocate(16);
+  fill(block, 16, 1);
+
+  // Growing within the block keeps it in place
+  TEST_ASSERT_EQUAL_PTR(block, pool.reallocate(block, 16, 32));
+
+  // Growing past the block moves it to the heap with its bytes
+  void *grown = pool.reallocate(block, 32, 48);
+  TEST_ASSERT_FALSE(pool.owns(grown));
+  TEST_ASSERT_EQUAL(0, pool.getUsed());
+  assertFilled(grown, 16, 1);
+
+  // Shrinking back takes a block of the pool again
+  void *shrunk = pool.reallocate(grown, 48, 24);
+  TEST_ASSERT_TRUE(pool.owns(shrunk));
+  assertFilled(shrunk, 16, 1);
+  pool.deallocate(shrunk, 24);
+}
+
+void test_inline_allocator_moves_heap_block_inline() {
+  InlineAllocator<32> allocator;
+  void *inlined = allocator.allocate(16);
+  void *heap = allocator.allocate(8);
+  TEST_ASSERT_TRUE(allocator.owns(inlined));
+  TEST_ASSERT_FALSE(allocator.owns(heap));
+  fill(heap, 8, 10);
+
+  // Growing the heap block into the freed storage copies its 8 bytes only
+  allocator.deallocate(inlined, 16);
+  void *moved = allocator.reallocate(heap, 8, 24);
+  TEST_ASSERT_TRUE(allocator.owns(moved));
+  assertFilled(moved, 8, 10);
+
+  // Growing past the storage moves it back to the heap
+  void *grown = allocator.reallocate(moved, 24, 64);
+  TEST_ASSERT_FALSE(allocator.owns(grown));
+  assertFilled(grown, 8, 10);
+  allocator.deallocate(grown, 64);
+}
+
+void test_arena_chains_overflow_blocks() {
+  Arena arena(64);
+  void *first = arena.allocate(40);
+  TEST_ASSERT_EQUAL(40, arena.getUsed());
+
+  // The rest of the buffer is too small, the blocks come from the heap
+  void *second = arena.allocate(40);
+  void *third = arena.allocate(100);
+  TEST_ASSERT_NOT_NULL(second);
+  TEST_ASSERT_NOT_NULL(third);
+  TEST_ASSERT_TRUE(second != first && third != second);
+  TEST_ASSERT_EQUAL(40, arena.getUsed());
+  fill(second, 40, 0);
+  fill(third, 100, 0);
+
+  // The last buffer block grows in place while it fits
+  void *grown = arena.reallocate(first, 40, 64);
+  TEST_ASSERT_EQUAL_PTR(first, grown);
+  TEST_ASSERT_EQUAL(64, arena.getUsed());
+  fill(first, 20, 5);
+  void *moved = arena.reallocate(first, 64, 80);
+  TEST_ASSERT_TRUE(moved != first);
+  assertFilled(moved, 20, 5);
+
+  // Release frees every overflow block, the sanitizer reports any leak
+  arena.release();
+  TEST_ASSERT_EQUAL(0, arena.getUsed());
+  TEST_ASSERT_EQUAL(64, arena.getPeak());
+  TEST_ASSERT_EQUAL_PTR(first, arena.allocate(8));
+}
+
+void test_arena_scope_releases_on_exit() {
+  Arena arena(128);
+  {
+    ArenaScope scope(arena);
+    ArenaAllocator allocator(arena);
+    allocator.allocate(48);
+    allocator.allocate(200);
+    TEST_ASSERT_GREATER_OR_EQUAL(48, arena.getUsed());
+  }
+  TEST_ASSERT_EQUAL(0, arena.getUsed());
+  TEST_ASSERT_GREATER_OR_EQUAL(48, arena.getPeak());
+
+  // Collections allocating from the arena are destroyed before the scope
+  {
+    ArenaScope scope(arena);
+    ArrayList<int, ArenaAllocator> list(4, ArenaAllocator(arena));
+    for (int i = 0; i < 100; i++) {
+      list.add(i);
+    }
+    TEST_ASSERT_EQUAL(99, list.get(99));
+  }
+  TEST_ASSERT_EQUAL(0, arena.getUsed());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_pool_falls_back_to_heap_when_empty);
+  RUN_TEST(test_pool_reallocates_across_block_size);
+  RUN_TEST(test_inline_allocator_moves_heap_block_inline);
+  RUN_TEST(test_arena_chains_overflow_blocks);
+  RUN_TEST(test_arena_scope_releases_on_exit);
+  return UNITY_END();
+}
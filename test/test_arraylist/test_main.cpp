@@ -0,0 +1,192 @@
+#include <ArrayList.h>
+#include <StreamString.h>
+#include <Tracked.h>
+#include <unity.h>
+
+void setUp() { Tracked::copies = 0; }
+void tearDown() {}
+
+void test_add_and_get() {
+  ArrayList<String> list;
+  list.add("first");
+  list.add(String("second"));
+  list.emplace("third");
+
+  TEST_ASSERT_EQUAL(3, list.size());
+  TEST_ASSERT_EQUAL_STRING("first", list.get(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("third", list.get(2).c_str());
+
+  list.get(1) += "!";
+  TEST_ASSERT_EQUAL_STRING("second!", list.get(1).c_str());
+
+  bool isThrown = false;
+  try {
+    list.get(3);
+  } catch (const std::out_of_range &) {
+    isThrown = true;
+  }
+  TEST_ASSERT_TRUE(isThrown);
+}
+
+void test_grows_past_initial_capacity() {
+  ArrayList<int> list(2);
+  for (int i = 0; i < 100; i++) {
+    list.add(i);
+  }
+
+  TEST_ASSERT_EQUAL(100, list.size());
+  TEST_ASSERT_GREATER_OR_EQUAL(100, list.getCapacity());
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_EQUAL(i, list.get(i));
+  }
+}
+
+void test_insert_and_remove() {
+  ArrayList<String> list;
+  list.add("a");
+  list.add("c");
+  list.add(1, "b");
+  list.add(0, "start");
+
+  TEST_ASSERT_EQUAL(4, list.size());
+  TEST_ASSERT_EQUAL_STRING("start", list.get(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("b", list.get(2).c_str());
+
+  list.remove((size_t)0);
+  TEST_ASSERT_TRUE(list.remove(String("b")));
+  TEST_ASSERT_FALSE(list.remove(String("missing")));
+
+  TEST_ASSERT_EQUAL(2, list.size());
+  TEST_ASSERT_EQUAL_STRING("a", list.get(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("c", list.get(1).c_str());
+  TEST_ASSERT_EQUAL(1, *list.find(String("c")));
+  TEST_ASSERT_FALSE(list.find(String("b")).has_value());
+}
+
+void test_remove_if_keeps_order() {
+  ArrayList<int> list;
+  for (int i = 0; i < 10; i++) {
+    list.add(i);
+  }
+
+  size_t removed = list.removeIf([](const int &item) { return item % 3 == 0; });
+
+  TEST_ASSERT_EQUAL(4, removed);
+  TEST_ASSERT_EQUAL(6, list.size());
+  const int expected[] = {1, 2, 4, 5, 7, 8};
+  for (size_t i = 0; i < list.size(); i++) {
+    TEST_ASSERT_EQUAL(expected[i], list.get(i));
+  }
+}
+
+void test_swap_remove_moves_last_item() {
+  ArrayList<String> list;
+  list.add("a");
+  list.add("b");
+  list.add("c");
+
+  list.swapRemove(0);
+
+  TEST_ASSERT_EQUAL(2, list.size());
+  TEST_ASSERT_EQUAL_STRING("c", list.get(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("b", list.get(1).c_str());
+}
+
+void test_copy_is_independent() {
+  ArrayList<String> list;
+  list.add("a");
+  list.add("b");
+
+  ArrayList<String> copy(list);
+  copy.add("c");
+  copy.get(0) = "changed";
+
+  TEST_ASSERT_EQUAL(2, list.size());
+  TEST_ASSERT_EQUAL_STRING("a", list.get(0).c_str());
+  TEST_ASSERT_EQUAL(3, copy.size());
+
+  list = copy;
+  TEST_ASSERT_EQUAL(3, list.size());
+  TEST_ASSERT_EQUAL_STRING("changed", list.get(0).c_str());
+}
+
+void test_move_leaves_source_empty() {
+  ArrayList<String> list;
+  list.add("a");
+  list.add("b");
+
+  ArrayList<String> moved(std::move(list));
+  TEST_ASSERT_EQUAL(2, moved.size());
+  TEST_ASSERT_EQUAL(0, list.size());
+
+  // A moved-from list can be filled again
+  list.add("c");
+  TEST_ASSERT_EQUAL_STRING("c", list.get(0).c_str());
+
+  list = std::move(moved);
+  TEST_ASSERT_EQUAL(2, list.size());
+  TEST_ASSERT_EQUAL_STRING("b", list.get(1).c_str());
+  TEST_ASSERT_EQUAL(0, moved.size());
+}
+
+void test_reserve_and_shrink_to_fit() {
+  ArrayList<int> list;
+  list.reserve(64);
+  TEST_ASSERT_EQUAL(64, list.getCapacity());
+
+  list.add(1);
+  list.add(2);
+  list.shrinkToFit();
+  TEST_ASSERT_EQUAL(2, list.getCapacity());
+  TEST_ASSERT_EQUAL(2, list.get(1));
+
+  list.clear();
+  TEST_ASSERT_TRUE(list.isEmpty());
+  TEST_ASSERT_EQUAL(2, list.getCapacity());
+}
+
+void test_print_json() {
+  ArrayList<String> list;
+  list.add("plain");
+  list.add("quote \" and \\");
+  list.add("line\nbreak");
+
+  StreamString out;
+  size_t written = list.printJsonTo(out);
+
+  TEST_ASSERT_EQUAL_STRING(
+      "[\"plain\",\"quote \\\" and \\\\\",\"line\\nbreak\"]", out.c_str());
+  TEST_ASSERT_EQUAL(out.length(), written);
+  TEST_ASSERT_EQUAL(written, list.measureJsonLength());
+}
+
+void test_items_are_moved_not_copied() {
+  ArrayList<Tracked> list(1);
+  for (int i = 0; i < 100; i++) {
+    Tracked item(i);
+    list.add(std::move(item));
+  }
+  list.emplace(100);
+  list.add(0, Tracked(-1));
+  list.remove((size_t)50);
+
+  TEST_ASSERT_EQUAL(0, Tracked::copies);
+  TEST_ASSERT_EQUAL(101, list.size());
+  TEST_ASSERT_EQUAL(-1, list.get(0).value);
+  TEST_ASSERT_EQUAL(100, list.get(100).value);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_add_and_get);
+  RUN_TEST(test_grows_past_initial_capacity);
+  RUN_TEST(test_insert_and_remove);
+  RUN_TEST(test_remove_if_keeps_order);
+  RUN_TEST(test_swap_remove_moves_last_item);
+  RUN_TEST(test_copy_is_independent);
+  RUN_TEST(test_move_leaves_source_empty);
+  RUN_TEST(test_reserve_and_shrink_to_fit);
+  RUN_TEST(test_print_json);
+  RUN_TEST(test_items_are_moved_not_copied);
+  return UNITY_END();
+}
@@ -0,0 +1,445 @@
+// Host benchmark of ArrayList and HashMap against std::vector and
+// std::unordered_map. Every operation is timed at sizes from 4 to 10k items
+// and reported as ns/op and allocations/op through TEST_MESSAGE. FlatMap is
+// timed against HashMap from 2 items up, the sizes it is meant for. The
+// numbers are relative: the host is far faster than the ESP32, but the
+// layout differences between the containers show up the same way.
+
+#include <AllocationCounter.h>
+#include <ArrayList.h>
+#include <FlatMap.h>
+#include <HashMap.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string_view>
+#include <unity.h>
+#include <unordered_map>
+#include <vector>
+
+// Number of operations timed per size, spread over several rounds
+#define BENCHMARK_OPERATIONS 20000
+
+/**
+ * @brief A heap allocator that counts its allocations.
+ * The collections allocate with malloc rather than operator new, so their
+ * allocations are added to the count of AllocationCounter.h here.
+ */
+struct CountingAllocator : HeapAllocator {
+  void *allocate(size_t size) {
+    allocations++;
+    return HeapAllocator::allocate(size);
+  }
+
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    allocations++;
+    return HeapAllocator::reallocate(ptr, oldSize, newSize);
+  }
+};
+
+/**
+ * @brief Hasher of String keys for std::unordered_map.
+ */
+struct StringHash {
+  size_t operator()(const String &key) const {
+    return std::hash<std::string_view>()(
+        std::string_view(key.c_str(), key.length()));
+  }
+};
+
+void setUp() {}
+void tearDown() {}
+
+using List = ArrayList<String, CountingAllocator>;
+using Map = HashMap<String, String, Hash<String>, CountingAllocator>;
+using StdMap = std::unordered_map<String, String, StringHash>;
+using Flat = FlatMap<String, String, CountingAllocator>;
+
+/**
+ * @brief The cost of one operation.
+ */
+struct Cost {
+  double nanoseconds;
+  double allocations;
+};
+
+static const size_t SIZES[] = {4, 16, 64, 256, 1024, 10000};
+static const size_t FLAT_SIZES[] = {2, 4, 8, 16, 64, 256, 1024};
+
+/**
+ * @brief Times an operation repeated over a fresh state.
+ * The state is prepared and destroyed outside the timed part, so only the
+ * operations themselves are measured.
+ *
+ * @param operations The number of operations run by one call of run.
+ * @param prepare Builds the state of a round.
+ * @param run Runs the operations on the state.
+ * @return The average cost of an operation.
+ */
+template <typename Prepare, typename Run>
+Cost measure(size_t operations, Prepare prepare, Run run) {
+  size_t rounds = BENCHMARK_OPERATIONS / operations;
+  if (rounds == 0)
+    rounds = 1;
+
+  double elapsed = 0;
+  size_t allocated = 0;
+  for (size_t round = 0; round < rounds; round++) {
+    auto state = prepare();
+    allocations = 0;
+    auto started = std::chrono::steady_clock::now();
+    run(state);
+    auto ended = std::chrono::steady_clock::now();
+    allocated += allocations;
+    elapsed +=
+        std::chrono::duration<double, std::nano>(ended - started).count();
+  }
+
+  double total = (double)operations * rounds;
+  return Cost{elapsed / total, allocated / total};
+}
+
+/**
+ * @brief Reports the cost of an operation next to its counterpart.
+ *
+ * @param operation The name of the operation.
+ * @param size The number of items.
+ * @param cost The cost with the collection.
+ * @param stdCost The cost with the counterpart.
+ * @param baseline The name of the counterpart.
+ */
+void report(const char *operation, size_t size, const Cost &cost,
+            const Cost &stdCost, const char *baseline = "std") {
+  char line[160];
+  snprintf(line, sizeof(line),
+           "%-14s n=%-5zu %8.1f ns/op %6.2f alloc/op | %s %8.1f ns/op "
+           "%6.2f alloc/op",
+           operation, size, cost.nanoseconds, cost.allocations, baseline,
+           stdCost.nanoseconds, stdCost.allocations);
+  TEST_MESSAGE(line);
+}
+
+/**
+ * @brief Makes the keys of a benchmark, shaped like card UIDs.
+ *
+ * @param size The number of keys.
+ * @return The keys.
+ */
+std::vector<String> makeKeys(size_t size) {
+  std::vector<String> keys;
+  for (size_t i = 0; i < size; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "%02X %02X %02X %02X", (unsigned)(i >> 24),
+             (unsigned)(i >> 16) & 0xFF, (unsigned)(i >> 8) & 0xFF,
+             (unsigned)i & 0xFF);
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+/**
+ * @brief Makes the keys of a benchmark in the order cards arrive, which is
+ * not the sorted order of a FlatMap.
+ *
+ * @param size The number of keys.
+ * @return The keys, shuffled.
+ */
+std::vector<String> makeShuffledKeys(size_t size) {
+  std::vector<String> keys = makeKeys(size);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(size));
+  return keys;
+}
+
+List makeList(const std::vector<String> &keys) {
+  List list;
+  for (const String &key : keys) {
+    list.add(key);
+  }
+  return list;
+}
+
+Map makeMap(const std::vector<String> &keys) {
+  Map map;
+  for (const String &key : keys) {
+    map.put(key, key);
+  }
+  return map;
+}
+
+Flat makeFlat(const std::vector<String> &keys) {
+  Flat map;
+  for (const String &key : keys) {
+    map.put(key, key);
+  }
+  return map;
+}
+
+StdMap makeStdMap(const std::vector<String> &keys) {
+  StdMap map;
+  for (const String &key : keys) {
+    map.emplace(key, key);
+  }
+  return map;
+}
+
+void test_arraylist_add() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Cost cost = measure(
+        size, [] { return List(); },
+        [&keys](List &list) {
+          for (const String &key : keys) {
+            list.add(key);
+          }
+        });
+    Cost stdCost = measure(
+        size, [] { return std::vector<String>(); },
+        [&keys](std::vector<String> &list) {
+          for (const String &key : keys) {
+            list.push_back(key);
+          }
+        });
+    report("ArrayList add", size, cost, stdCost);
+  }
+}
+
+void test_arraylist_get() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    List list = makeList(keys);
+    size_t length = 0;
+    Cost cost = measure(
+        size, [] { return 0; },
+        [&list, &length](int &) {
+          for (size_t i = 0; i < list.size(); i++) {
+            length += list.get(i).length();
+          }
+        });
+    size_t stdLength = 0;
+    Cost stdCost = measure(
+        size, [] { return 0; },
+        [&keys, &stdLength](int &) {
+          for (size_t i = 0; i < keys.size(); i++) {
+            stdLength += keys[i].length();
+          }
+        });
+    TEST_ASSERT_EQUAL(stdLength, length);
+    report("ArrayList get", size, cost, stdCost);
+  }
+}
+
+void test_arraylist_remove() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Cost cost = measure(
+        size, [&keys] { return makeList(keys); },
+        [](List &list) {
+          while (!list.isEmpty()) {
+            list.remove((size_t)0);
+          }
+        });
+    Cost stdCost = measure(
+        size, [&keys] { return keys; },
+        [](std::vector<String> &list) {
+          while (!list.empty()) {
+            list.erase(list.begin());
+          }
+        });
+    report("ArrayList rm", size, cost, stdCost);
+  }
+}
+
+void test_hashmap_put() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Cost cost = measure(
+        size, [] { return Map(); },
+        [&keys](Map &map) {
+          for (const String &key : keys) {
+            map.put(key, key);
+          }
+        });
+    Cost stdCost = measure(
+        size, [] { return StdMap(); },
+        [&keys](StdMap &map) {
+          for (const String &key : keys) {
+            map.emplace(key, key);
+          }
+        });
+    report("HashMap put", size, cost, stdCost);
+  }
+}
+
+void test_hashmap_get() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Map map = makeMap(keys);
+    StdMap stdMap = makeStdMap(keys);
+    size_t found = 0;
+    Cost cost = measure(
+        size, [] { return 0; },
+        [&keys, &map, &found](int &) {
+          for (const String &key : keys) {
+            found += map.find(key) != nullptr;
+          }
+        });
+    size_t stdFound = 0;
+    Cost stdCost = measure(
+        size, [] { return 0; },
+        [&keys, &stdMap, &stdFound](int &) {
+          for (const String &key : keys) {
+            stdFound += stdMap.find(key) != stdMap.end();
+          }
+        });
+    TEST_ASSERT_EQUAL(stdFound, found);
+    report("HashMap get", size, cost, stdCost);
+  }
+}
+
+void test_hashmap_update() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Cost cost = measure(
+        size, [&keys] { return makeMap(keys); },
+        [&keys](Map &map) {
+          for (const String &key : keys) {
+            map.update(key, "updated");
+          }
+        });
+    Cost stdCost = measure(
+        size, [&keys] { return makeStdMap(keys); },
+        [&keys](StdMap &map) {
+          for (const String &key : keys) {
+            map[key] = "updated";
+          }
+        });
+    report("HashMap update", size, cost, stdCost);
+  }
+}
+
+void test_flatmap_put() {
+  for (size_t size : FLAT_SIZES) {
+    std::vector<String> keys = makeShuffledKeys(size);
+    Cost cost = measure(
+        size, [] { return Flat(); },
+        [&keys](Flat &map) {
+          for (const String &key : keys) {
+            map.put(key, key);
+          }
+        });
+    Cost mapCost = measure(
+        size, [] { return Map(); },
+        [&keys](Map &map) {
+          for (const String &key : keys) {
+            map.put(key, key);
+          }
+        });
+    report("FlatMap put", size, cost, mapCost, "HashMap");
+  }
+}
+
+void test_flatmap_get() {
+  for (size_t size : FLAT_SIZES) {
+    std::vector<String> keys = makeShuffledKeys(size);
+    Flat flat = makeFlat(keys);
+    Map map = makeMap(keys);
+    size_t found = 0;
+    Cost cost = measure(
+        size, [] { return 0; },
+        [&keys, &flat, &found](int &) {
+          for (const String &key : keys) {
+            found += flat.find(key) != nullptr;
+          }
+        });
+    size_t mapFound = 0;
+    Cost mapCost = measure(
+        size, [] { return 0; },
+        [&keys, &map, &mapFound](int &) {
+          for (const String &key : keys) {
+            mapFound += map.find(key) != nullptr;
+          }
+        });
+    TEST_ASSERT_EQUAL(mapFound, found);
+    TEST_ASSERT_EQUAL(0, cost.allocations);
+    report("FlatMap get", size, cost, mapCost, "HashMap");
+  }
+}
+
+void test_to_json() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Map map = makeMap(keys);
+    List list = makeList(keys);
+    size_t written = 0;
+    Cost mapCost = measure(
+        size, [] { return CountingPrint(); },
+        [&map, &written](CountingPrint &out) {
+          written += map.printJsonTo(out);
+        });
+    Cost listCost = measure(
+        size, [] { return CountingPrint(); },
+        [&list, &written](CountingPrint &out) {
+          written += list.printJsonTo(out);
+        });
+
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%-14s n=%-5zu HashMap %6.1f ns/entry %6.2f alloc/entry | "
+             "ArrayList %6.1f ns/item %6.2f alloc/item",
+             "toJson", size, mapCost.nanoseconds, mapCost.allocations,
+             listCost.nanoseconds, listCost.allocations);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_GREATER_THAN(0, written);
+    TEST_ASSERT_EQUAL(0, mapCost.allocations);
+  }
+}
+
+void test_json_stream() {
+  for (size_t size : SIZES) {
+    std::vector<String> keys = makeKeys(size);
+    Map map = makeMap(keys);
+    List list = makeList(keys);
+    size_t read = 0;
+    Cost mapCost = measure(
+        map.measureJsonLength(), [&map] { return JsonStream<Map>(map); },
+        [&read](JsonStream<Map> &stream) {
+          while (stream.read() >= 0) {
+            read++;
+          }
+        });
+    Cost listCost = measure(
+        list.measureJsonLength(), [&list] { return JsonStream<List>(list); },
+        [&read](JsonStream<List> &stream) {
+          while (stream.read() >= 0) {
+            read++;
+          }
+        });
+
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%-14s n=%-5zu HashMap %6.1f ns/byte %6.2f alloc/byte | "
+             "ArrayList %6.1f ns/byte %6.2f alloc/byte",
+             "JsonStream", size, mapCost.nanoseconds, mapCost.allocations,
+             listCost.nanoseconds, listCost.allocations);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_GREATER_THAN(0, read);
+    TEST_ASSERT_EQUAL(0, mapCost.allocations);
+    TEST_ASSERT_EQUAL(0, listCost.allocations);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_arraylist_add);
+  RUN_TEST(test_arraylist_get);
+  RUN_TEST(test_arraylist_remove);
+  RUN_TEST(test_hashmap_put);
+  RUN_TEST(test_hashmap_get);
+  RUN_TEST(test_hashmap_update);
+  RUN_TEST(test_flatmap_put);
+  RUN_TEST(test_flatmap_get);
+  RUN_TEST(test_to_json);
+  RUN_TEST(test_json_stream);
+  return UNITY_END();
+}
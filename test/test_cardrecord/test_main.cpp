@@ -0,0 +1,192 @@
+#include <CardRecord.h>
+#include <unity.h>
+
+// Key of the signer under test, the bytes 0 to 31
+static uint8_t TEST_KEY[CARD_RECORD_KEY_SIZE];
+
+static CardSigner signer;
+
+/**
+ * @brief Makes a card UID from its bytes.
+ *
+ * @param bytes The UID bytes.
+ * @return The UID.
+ */
+template <size_t N> CardUID makeUID(const uint8_t (&bytes)[N]) {
+  CardUID uid;
+  uid.size = N;
+  memcpy(uid.bytes, bytes, N);
+  return uid;
+}
+
+static const uint8_t CARD_BYTES[] = {0x04, 0xA1, 0xB2, 0xC3};
+static const uint8_t OTHER_CARD_BYTES[] = {0x04, 0xA1, 0xB2, 0xC4};
+
+/**
+ * @brief Makes the member used by most tests.
+ */
+MemberRecord makeMember() {
+  MemberRecord member;
+  member.id = "1234";
+  member.nim = "2201234567";
+  member.division = "keor";
+  return member;
+}
+
+void setUp() {
+  for (size_t i = 0; i < CARD_RECORD_KEY_SIZE; i++) {
+    TEST_KEY[i] = i;
+  }
+  signer.setKey(TEST_KEY, sizeof(TEST_KEY));
+}
+
+void tearDown() {}
+
+void test_round_trip() {
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  CardUID uid = makeUID(CARD_BYTES);
+  TEST_ASSERT_TRUE(signer.encode(record, uid, block));
+
+  CardRecord decoded;
+  TEST_ASSERT_TRUE(signer.decode(block, uid, decoded));
+  TEST_ASSERT_EQUAL_UINT32(1234, decoded.memberId);
+  TEST_ASSERT_EQUAL_STRING("KEOR", decoded.divisionName());
+  TEST_ASSERT_EQUAL_STRING("2201234567", decoded.nim);
+}
+
+void test_block_layout_and_tag() {
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  TEST_ASSERT_TRUE(signer.encode(record, makeUID(CARD_BYTES), block));
+
+  // Tag computed independently with HMAC-SHA256 over the UID and the
+  // first 12 bytes
+  const uint8_t expected[CARD_BLOCK_SIZE] = {
+      0x01, 0x01, 0x00, 0x00, 0x04, 0xD2, 0x22, 0x01,
+      0x23, 0x45, 0x67, 0xFF, 0x3B, 0x22, 0xAD, 0xCF,
+  };
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, block, CARD_BLOCK_SIZE);
+}
+
+void test_tampered_block_is_rejected() {
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  CardUID uid = makeUID(CARD_BYTES);
+  TEST_ASSERT_TRUE(signer.encode(record, uid, block));
+
+  // Any single flipped bit, in the fields or in the tag, fails the check
+  for (size_t i = 0; i < CARD_BLOCK_SIZE; i++) {
+    for (uint8_t bit = 1; bit != 0; bit <<= 1) {
+      uint8_t tampered[CARD_BLOCK_SIZE];
+      memcpy(tampered, block, sizeof(block));
+      tampered[i] ^= bit;
+
+      CardRecord decoded;
+      TEST_ASSERT_FALSE(signer.decode(tampered, uid, decoded));
+    }
+  }
+}
+
+void test_copied_record_is_rejected() {
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  TEST_ASSERT_TRUE(signer.encode(record, makeUID(CARD_BYTES), block));
+
+  CardRecord decoded;
+  TEST_ASSERT_FALSE(signer.decode(block, makeUID(OTHER_CARD_BYTES), decoded));
+}
+
+void test_other_key_is_rejected() {
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  CardUID uid = makeUID(CARD_BYTES);
+  TEST_ASSERT_TRUE(signer.encode(record, uid, block));
+
+  CardSigner other;
+  CardRecord decoded;
+  TEST_ASSERT_FALSE(other.decode(block, uid, decoded));
+
+  uint8_t otherKey[] = {0x42};
+  other.setKey(otherKey, sizeof(otherKey));
+  TEST_ASSERT_FALSE(other.decode(block, uid, decoded));
+}
+
+void test_signer_without_key_doesnt_encode() {
+  CardSigner empty;
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+
+  uint8_t block[CARD_BLOCK_SIZE];
+  TEST_ASSERT_FALSE(empty.isReady());
+  TEST_ASSERT_FALSE(empty.encode(record, makeUID(CARD_BYTES), block));
+}
+
+void test_assign_rejects_members_that_dont_fit() {
+  CardRecord record;
+  MemberRecord member = makeMember();
+  member.id = "12a4";
+  TEST_ASSERT_FALSE(record.assign(member));
+
+  member = makeMember();
+  member.id = "4294967296"; // One past UINT32_MAX
+  TEST_ASSERT_FALSE(record.assign(member));
+
+  member = makeMember();
+  member.nim = "1234567890123";
+  TEST_ASSERT_FALSE(record.assign(member));
+
+  member = makeMember();
+  member.division = "UNKNOWN";
+  TEST_ASSERT_FALSE(record.assign(member));
+
+  member = makeMember();
+  member.id = "4294967295";
+  member.nim = "123456789012";
+  TEST_ASSERT_TRUE(record.assign(member));
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, record.memberId);
+}
+
+void test_key_is_kept_in_preferences() {
+  Preferences pref;
+  CardSigner first;
+  first.begin(pref);
+  TEST_ASSERT_TRUE(first.isReady());
+  TEST_ASSERT_EQUAL(CARD_RECORD_KEY_SIZE, pref.getBytesLength("card_key"));
+
+  CardRecord record;
+  TEST_ASSERT_TRUE(record.assign(makeMember()));
+  uint8_t block[CARD_BLOCK_SIZE];
+  CardUID uid = makeUID(CARD_BYTES);
+  TEST_ASSERT_TRUE(first.encode(record, uid, block));
+
+  // A signer started after a reboot loads the same key
+  CardSigner second;
+  second.begin(pref);
+  CardRecord decoded;
+  TEST_ASSERT_TRUE(second.decode(block, uid, decoded));
+  TEST_ASSERT_EQUAL(1, pref.writes);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_block_layout_and_tag);
+  RUN_TEST(test_tampered_block_is_rejected);
+  RUN_TEST(test_copied_record_is_rejected);
+  RUN_TEST(test_other_key_is_rejected);
+  RUN_TEST(test_signer_without_key_doesnt_encode);
+  RUN_TEST(test_assign_rejects_members_that_dont_fit);
+  RUN_TEST(test_key_is_kept_in_preferences);
+  return UNITY_END();
+}
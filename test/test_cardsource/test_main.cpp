@@ -0,0 +1,155 @@
+#include <CardReader.h>
+#include <TapPipeline.h>
+#include <thread>
+#include <unity.h>
+
+// Longest time a woken wait may take on a busy host
+#define WAKE_SLACK 500
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Makes the UID of the n-th card of a test, like "04 00 00 2A".
+ */
+CardUID makeUID(uint8_t card) {
+  CardUID uid;
+  uid.size = 4;
+  uid.bytes[0] = 0x04;
+  uid.bytes[3] = card;
+  return uid;
+}
+
+/**
+ * @brief Reads the field in one pass the way the reader task does, and
+ * joins the UIDs like "04 00 00 01,04 00 00 02,".
+ */
+String readPass(CardSource &source) {
+  TapEvent cards[CARD_INVENTORY_SIZE];
+  size_t cardCount = source.readCards(cards, CARD_INVENTORY_SIZE);
+
+  String uids;
+  for (size_t i = 0; i < cardCount; i++) {
+    uids += cards[i].uid.toString() + ",";
+  }
+  return uids;
+}
+
+void test_one_pass_reads_every_card() {
+  SimulatedCardSource source;
+  source.begin();
+  source.enter(makeUID(1));
+  source.enter(makeUID(2));
+  source.enter(makeUID(3));
+
+  // Anticollision selects the cards in the order they entered
+  TEST_ASSERT_TRUE(source.waitForCard(CARD_WAIT_TIMEOUT));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 01,04 00 00 02,04 00 00 03,",
+                           readPass(source).c_str());
+
+  // Every card was halted by the pass, so none answers anymore
+  TEST_ASSERT_FALSE(source.waitForCard(10));
+  TEST_ASSERT_EQUAL_STRING("", readPass(source).c_str());
+}
+
+void test_halted_card_waits_for_reentry() {
+  SimulatedCardSource source;
+  source.enter(makeUID(1));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 01,", readPass(source).c_str());
+
+  // Entering again while still in the field keeps the card halted
+  source.enter(makeUID(1));
+  TEST_ASSERT_FALSE(source.waitForCard(10));
+
+  // A new card is read on its own
+  source.enter(makeUID(2));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 02,", readPass(source).c_str());
+
+  // Once out of the field, the card is read again when it comes back
+  source.leave(makeUID(1));
+  TEST_ASSERT_EQUAL_STRING("", readPass(source).c_str());
+  source.enter(makeUID(1));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 01,", readPass(source).c_str());
+
+  // A tapped card leaves the field as soon as it's read
+  source.tap(makeUID(3));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 03,", readPass(source).c_str());
+  source.tap(makeUID(3));
+  TEST_ASSERT_EQUAL_STRING("04 00 00 03,", readPass(source).c_str());
+}
+
+void test_pass_stops_at_inventory_size() {
+  SimulatedCardSource source;
+  for (uint8_t card = 0; card < CARD_INVENTORY_SIZE + 3; card++) {
+    source.enter(makeUID(card));
+  }
+
+  // A spare slot after the inventory is never written
+  TapEvent cards[CARD_INVENTORY_SIZE + 1];
+  TEST_ASSERT_EQUAL(CARD_INVENTORY_SIZE,
+                    source.readCards(cards, CARD_INVENTORY_SIZE));
+  TEST_ASSERT_EQUAL(0, cards[CARD_INVENTORY_SIZE].uid.size);
+  for (uint8_t card = 0; card < CARD_INVENTORY_SIZE; card++) {
+    TEST_ASSERT_TRUE(cards[card].uid == makeUID(card));
+    TEST_ASSERT_FALSE(cards[card].hasRecord);
+  }
+
+  // The cards left over answer the next pass
+  TEST_ASSERT_TRUE(source.waitForCard(10));
+  TEST_ASSERT_EQUAL(3, source.readCards(cards, CARD_INVENTORY_SIZE));
+  TEST_ASSERT_TRUE(cards[0].uid == makeUID(CARD_INVENTORY_SIZE));
+  TEST_ASSERT_TRUE(cards[2].uid == makeUID(CARD_INVENTORY_SIZE + 2));
+  TEST_ASSERT_EQUAL(0, source.readCards(cards, CARD_INVENTORY_SIZE));
+}
+
+void test_wait_times_out_without_card() {
+  SimulatedCardSource source;
+  uint32_t started = millis();
+  TEST_ASSERT_FALSE(source.waitForCard(50));
+  uint32_t elapsed = millis() - started;
+  TEST_ASSERT_GREATER_OR_EQUAL(50, elapsed);
+  TEST_ASSERT_LESS_THAN(50 + WAKE_SLACK, elapsed);
+
+  // A halted card in the field doesn't end the wait either
+  source.enter(makeUID(1));
+  readPass(source);
+  started = millis();
+  TEST_ASSERT_FALSE(source.waitForCard(50));
+  TEST_ASSERT_GREATER_OR_EQUAL(50, millis() - started);
+}
+
+void test_enter_wakes_waiting_reader() {
+  SimulatedCardSource source;
+  source.enter(makeUID(1));
+  readPass(source);
+
+  // The card enters from another thread while the reader is asleep
+  std::thread tapper([&source] {
+    delay(50);
+    source.enter(makeUID(2));
+  });
+  uint32_t started = millis();
+  TEST_ASSERT_TRUE(source.waitForCard(10000));
+  uint32_t elapsed = millis() - started;
+  tapper.join();
+
+  TEST_ASSERT_GREATER_OR_EQUAL(40, elapsed);
+  TEST_ASSERT_LESS_THAN(50 + WAKE_SLACK, elapsed);
+  TEST_ASSERT_EQUAL_STRING("04 00 00 02,", readPass(source).c_str());
+
+  // A card that entered before the wait is found without sleeping
+  source.tap(makeUID(3));
+  started = millis();
+  TEST_ASSERT_TRUE(source.waitForCard(10000));
+  TEST_ASSERT_LESS_THAN(WAKE_SLACK, millis() - started);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_one_pass_reads_every_card);
+  RUN_TEST(test_halted_card_waits_for_reentry);
+  RUN_TEST(test_pass_stops_at_inventory_size);
+  RUN_TEST(test_wait_times_out_without_card);
+  RUN_TEST(test_enter_wakes_waiting_reader);
+  return UNITY_END();
+}
@@ -0,0 +1,139 @@
+// Built by [env:native_stats] only, which compiles the collections with
+// ENABLE_COLLECTION_STATS.
+
+#include <ArrayList.h>
+#include <HashMap.h>
+#include <StreamString.h>
+#include <stdio.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief A line of the stats report, parsed back into its numbers.
+ */
+struct ReportLine {
+  bool isFound = false;
+  // Number of lines of the label, one per live instance
+  unsigned lines = 0;
+  char state[8] = {};
+  unsigned instances = 0;
+  unsigned allocations = 0;
+  unsigned bytes = 0;
+  unsigned peak = 0;
+  unsigned resizes = 0;
+  // Text after the resizes, the probe counts of maps
+  String rest;
+};
+
+/**
+ * @brief Finds the report line of a label in the current stats report.
+ *
+ * @param state "live" or "retired".
+ * @param label The label of the line.
+ * @return The first parsed line, not found if the report has none.
+ */
+ReportLine findLine(const char *state, const char *label) {
+  StreamString report;
+  CollectionStats::dump(report);
+
+  ReportLine found;
+  int start = 0;
+  while (start < (int)report.length()) {
+    int end = report.indexOf('\n', start);
+    if (end < 0)
+      end = report.length();
+    String text = report.substring(start, end);
+    start = end + 1;
+
+    ReportLine line;
+    char lineLabel[32];
+    int consumed = 0;
+    if (sscanf(text.c_str(), "%7s %31s x%u %u allocs %u B peak %u %u resizes%n",
+               line.state, lineLabel, &line.instances, &line.allocations,
+               &line.bytes, &line.peak, &line.resizes, &consumed) == 7 &&
+        strcmp(line.state, state) == 0 && strcmp(lineLabel, label) == 0) {
+      if (!found.isFound) {
+        found = line;
+        found.isFound = true;
+        found.rest = text.substring(consumed);
+      }
+      found.lines++;
+    }
+  }
+  return found;
+}
+
+void test_counters_keep_totals_and_peaks() {
+  CollectionStats stats("unit");
+  stats.recordAllocation(16);
+  stats.recordAllocation(48);
+  stats.recordResize(8);
+  stats.recordResize(4);
+  stats.recordCapacity(6);
+  stats.recordLookup(3);
+  stats.recordLookup(1);
+
+  TEST_ASSERT_EQUAL(2, stats.counters.allocations);
+  TEST_ASSERT_EQUAL(64, stats.counters.bytes);
+  TEST_ASSERT_EQUAL(2, stats.counters.resizes);
+  TEST_ASSERT_EQUAL(8, stats.counters.peakCapacity);
+  TEST_ASSERT_EQUAL(2, stats.counters.lookups);
+  TEST_ASSERT_EQUAL(4, stats.counters.probes);
+  TEST_ASSERT_EQUAL(3, stats.counters.maxProbe);
+}
+
+void test_live_list_is_reported_by_label() {
+  ArrayList<int> list(4);
+  COLLECTION_LABEL(list, "tapList");
+  for (int i = 0; i < 10; i++) {
+    list.add(i);
+  }
+
+  // The buffer grew from 4 to 8 to 16 items
+  ReportLine line = findLine("live", "tapList");
+  TEST_ASSERT_TRUE(line.isFound);
+  TEST_ASSERT_EQUAL(1, line.lines);
+  TEST_ASSERT_EQUAL(1, line.instances);
+  TEST_ASSERT_EQUAL(16, line.peak);
+  TEST_ASSERT_EQUAL(line.resizes, line.allocations);
+  TEST_ASSERT_GREATER_OR_EQUAL(2, line.resizes);
+  TEST_ASSERT_GREATER_OR_EQUAL((8 + 16) * sizeof(int), line.bytes);
+
+  // A copy is a new instance with its own counters
+  ArrayList<int> copy = list;
+  TEST_ASSERT_EQUAL(2, findLine("live", "tapList").lines);
+  TEST_ASSERT_FALSE(findLine("retired", "tapList").isFound);
+}
+
+void test_destroyed_maps_are_totalled() {
+  for (int round = 0; round < 2; round++) {
+    HashMap<int, int> map;
+    COLLECTION_LABEL(map, "shortMap");
+    for (int i = 0; i < 4; i++) {
+      map.put(i, i);
+    }
+    TEST_ASSERT_NOT_NULL(map.find(2));
+    TEST_ASSERT_TRUE(findLine("live", "shortMap").isFound);
+  }
+
+  ReportLine line = findLine("retired", "shortMap");
+  TEST_ASSERT_TRUE(line.isFound);
+  TEST_ASSERT_EQUAL(1, line.lines);
+  TEST_ASSERT_EQUAL(2, line.instances);
+  TEST_ASSERT_FALSE(findLine("live", "shortMap").isFound);
+
+  // Four entries and a bucket array per map
+  TEST_ASSERT_EQUAL(2 * 5, line.allocations);
+  TEST_ASSERT_EQUAL(2, line.resizes);
+  TEST_ASSERT_TRUE(line.rest.indexOf("probes/lookup") >= 0);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_counters_keep_totals_and_peaks);
+  RUN_TEST(test_live_list_is_reported_by_label);
+  RUN_TEST(test_destroyed_maps_are_totalled);
+  return UNITY_END();
+}
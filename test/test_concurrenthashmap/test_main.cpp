@@ -0,0 +1,215 @@
+// Host contention benchmark of ConcurrentHashMap against a HashMap behind a
+// single mutex. Every thread count runs the same mix of lookups and updates
+// on a shared set of card UIDs, and the wall time per operation of both maps
+// is reported through TEST_MESSAGE. The host has more cores than the ESP32,
+// so the numbers show how the striping scales rather than kiosk timings.
+
+#include <ConcurrentHashMap.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+// Number of operations run by every thread of a benchmark
+#define CONTENTION_OPERATIONS 50000
+
+// Number of distinct keys the threads share
+#define CONTENTION_KEYS 256
+
+// One operation in this many is an update, the rest are lookups
+#define CONTENTION_UPDATE_EVERY 10
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief A HashMap guarded by a single mutex, with the calls of
+ * ConcurrentHashMap that the benchmark uses.
+ */
+class LockedHashMap {
+  private:
+  std::mutex lock;
+  HashMap<String, String> map;
+
+  public:
+  void put(const String &key, const String &value) {
+    std::lock_guard<std::mutex> guard(lock);
+    map.put(key, value);
+  }
+
+  bool get(const String &key, String &value) {
+    std::lock_guard<std::mutex> guard(lock);
+    const String *found = map.find(key);
+    if (found == nullptr)
+      return false;
+    value = *found;
+    return true;
+  }
+};
+
+/**
+ * @brief Makes the keys of a benchmark, shaped like card UIDs.
+ *
+ * @param size The number of keys.
+ * @return The keys.
+ */
+std::vector<String> makeKeys(size_t size) {
+  std::vector<String> keys;
+  for (size_t i = 0; i < size; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "%02X %02X %02X %02X", (unsigned)(i >> 24),
+             (unsigned)(i >> 16) & 0xFF, (unsigned)(i >> 8) & 0xFF,
+             (unsigned)i & 0xFF);
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+/**
+ * @brief Runs a function on several threads at once.
+ * The threads are released together, so the time covers only the part
+ * where they compete for the map.
+ *
+ * @param threads The number of threads.
+ * @param work The function run by every thread, given its number.
+ * @return The wall time of the run in nanoseconds.
+ */
+template <typename Work> double runThreads(size_t threads, Work work) {
+  std::atomic<bool> isStarted(false);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back([&isStarted, &work, i] {
+      while (!isStarted) {
+        std::this_thread::yield();
+      }
+      work(i);
+    });
+  }
+
+  auto started = std::chrono::steady_clock::now();
+  isStarted = true;
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - started)
+      .count();
+}
+
+/**
+ * @brief Times the lookup and update mix on a map shared by the threads.
+ *
+ * @param map The map, filled with the keys.
+ * @param keys The keys of the map.
+ * @param threads The number of threads.
+ * @return The wall time of an operation in nanoseconds.
+ */
+template <typename Map>
+double measureContention(Map &map, const std::vector<String> &keys,
+                         size_t threads) {
+  std::atomic<size_t> found(0);
+  double elapsed = runThreads(threads, [&map, &keys, &found](size_t thread) {
+    String value;
+    size_t hits = 0;
+    // Every thread walks the keys from a different place and stride
+    size_t key = thread * 31;
+    for (size_t i = 0; i < CONTENTION_OPERATIONS; i++) {
+      key = (key + 2 * thread + 1) % keys.size();
+      if (i % CONTENTION_UPDATE_EVERY == 0) {
+        map.put(keys[key], keys[key]);
+      } else {
+        hits += map.get(keys[key], value);
+      }
+    }
+    found += hits;
+  });
+
+  // Every key stays in the map, so every lookup finds its key
+  size_t lookups = CONTENTION_OPERATIONS -
+                   (CONTENTION_OPERATIONS + CONTENTION_UPDATE_EVERY - 1) /
+                       CONTENTION_UPDATE_EVERY;
+  TEST_ASSERT_EQUAL(lookups * threads, found.load());
+  return elapsed / (CONTENTION_OPERATIONS * threads);
+}
+
+void test_puts_from_threads_are_all_kept() {
+  std::vector<String> keys = makeKeys(2000);
+  ConcurrentHashMap<String, String> map;
+  runThreads(4, [&map, &keys](size_t thread) {
+    for (size_t i = thread; i < keys.size(); i += 4) {
+      map.put(keys[i], keys[i]);
+    }
+  });
+
+  TEST_ASSERT_EQUAL(keys.size(), map.size());
+  for (const String &key : keys) {
+    String value;
+    TEST_ASSERT_TRUE(map.get(key, value));
+    TEST_ASSERT_EQUAL_STRING(key.c_str(), value.c_str());
+  }
+
+  // Only one of the threads putting the same key inserts it
+  std::atomic<size_t> inserted(0);
+  runThreads(4, [&map, &inserted](size_t) {
+    inserted += map.putIfAbsent("FF FF FF FF", "new");
+  });
+  TEST_ASSERT_EQUAL(1, inserted.load());
+  TEST_ASSERT_EQUAL(keys.size() + 1, map.size());
+}
+
+void test_compute_counts_every_increment() {
+  std::vector<String> keys = makeKeys(16);
+  ConcurrentHashMap<String, int> taps;
+  runThreads(4, [&taps, &keys](size_t) {
+    for (size_t i = 0; i < 4000; i++) {
+      taps.compute(keys[i % keys.size()], [](int &count) { count++; });
+    }
+  });
+
+  TEST_ASSERT_EQUAL(keys.size(), taps.size());
+  int total = 0;
+  taps.foreach ([&total](const String &, const int &count) {
+    TEST_ASSERT_EQUAL(1000, count);
+    total += count;
+  });
+  TEST_ASSERT_EQUAL(16000, total);
+
+  TEST_ASSERT_TRUE(taps.remove(keys[0]));
+  TEST_ASSERT_FALSE(taps.containsKey(keys[0]));
+  taps.clear();
+  TEST_ASSERT_TRUE(taps.isEmpty());
+}
+
+void test_contention_against_single_lock() {
+  std::vector<String> keys = makeKeys(CONTENTION_KEYS);
+  static const size_t THREADS[] = {1, 2, 4, 8};
+  for (size_t threads : THREADS) {
+    ConcurrentHashMap<String, String> striped;
+    LockedHashMap locked;
+    for (const String &key : keys) {
+      striped.put(key, key);
+      locked.put(key, key);
+    }
+
+    double stripedCost = measureContention(striped, keys, threads);
+    double lockedCost = measureContention(locked, keys, threads);
+
+    char line[160];
+    snprintf(line, sizeof(line),
+             "threads=%zu striped %8.1f ns/op | single lock %8.1f ns/op "
+             "(%.2fx)",
+             threads, stripedCost, lockedCost, lockedCost / stripedCost);
+    TEST_MESSAGE(line);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_puts_from_threads_are_all_kept);
+  RUN_TEST(test_compute_counts_every_increment);
+  RUN_TEST(test_contention_against_single_lock);
+  return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include <Columns.h>
+#include <FlatMap.h>
+#include <StreamString.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+void test_foreach_visits_key_order() {
+  FlatMap<int, String> map;
+  const int keys[] = {42, 7, 19, 3, 88, 19};
+  for (int key : keys) {
+    map.put(key, String(key));
+  }
+
+  TEST_ASSERT_EQUAL(5, map.size());
+  const int expected[] = {3, 7, 19, 42, 88};
+  size_t index = 0;
+  map.foreach ([&index, &expected](const int &key, const String &value) {
+    TEST_ASSERT_EQUAL(expected[index], key);
+    TEST_ASSERT_EQUAL_STRING(String(key).c_str(), value.c_str());
+    index++;
+  });
+  TEST_ASSERT_EQUAL(5, index);
+}
+
+void test_c_string_keys_compare_text() {
+  // Distinct pointers to the same text must find the same entry
+  char nim[] = "nim";
+  char nama[] = "nama";
+  FlatMap<const char *, int> map;
+  map.put(nim, 1);
+  map.put(nama, 2);
+  map.put("divisi", 3);
+
+  TEST_ASSERT_EQUAL(1, map.get("nim"));
+  TEST_ASSERT_EQUAL(2, map.get("nama"));
+
+  const char *expected[] = {"divisi", "nama", "nim"};
+  size_t index = 0;
+  map.foreach ([&index, &expected](const char *const &key, const int &) {
+    TEST_ASSERT_EQUAL_STRING(expected[index], key);
+    index++;
+  });
+  TEST_ASSERT_EQUAL(3, index);
+}
+
+void test_lookup_update_and_remove() {
+  FlatMap<String, int> map;
+  map.put("hadir", 12);
+  map.put("izin", 3);
+  map.update("hadir", 13);
+  (*map.find("izin"))++;
+
+  TEST_ASSERT_EQUAL(13, map.get("hadir"));
+  TEST_ASSERT_EQUAL(4, map.get("izin"));
+  TEST_ASSERT_EQUAL(0, map.get("sakit"));
+  TEST_ASSERT_EQUAL(-1, map.getOrDefault("sakit", -1));
+  TEST_ASSERT_NULL(map.find("sakit"));
+  TEST_ASSERT_TRUE(map.containsValue(4));
+
+  TEST_ASSERT_TRUE(map.remove("hadir"));
+  TEST_ASSERT_FALSE(map.remove("hadir"));
+  TEST_ASSERT_EQUAL(1, map.size());
+  TEST_ASSERT_FALSE(map.containsKey("hadir"));
+  TEST_ASSERT_EQUAL(4, map.get("izin"));
+
+  map.clear();
+  TEST_ASSERT_TRUE(map.isEmpty());
+}
+
+void test_lookup_matches_hashmap() {
+  FlatMap<int, int> map;
+  HashMap<int, int> reference;
+  uint32_t seed = 1;
+  for (int i = 0; i < 500; i++) {
+    seed = seed * 1103515245 + 12345;
+    int key = (seed >> 16) % 200;
+    if (seed & 1) {
+      map.put(key, i);
+      reference.put(key, i);
+    } else {
+      TEST_ASSERT_EQUAL(reference.remove(key), map.remove(key));
+    }
+  }
+
+  TEST_ASSERT_EQUAL(reference.size(), map.size());
+  for (int key = 0; key < 200; key++) {
+    TEST_ASSERT_EQUAL(reference.containsKey(key), map.containsKey(key));
+    TEST_ASSERT_EQUAL(reference.get(key), map.get(key));
+  }
+
+  int previous = -1;
+  map.foreach ([&previous](const int &key, const int &) {
+    TEST_ASSERT_GREATER_THAN(previous, key);
+    previous = key;
+  });
+}
+
+void test_column_keys_print_names() {
+  FlatMap<Column, String> map;
+  map.put(Column::NAMA, "Budi");
+  map.put(Column::NIM, "123");
+
+  StreamString out;
+  size_t written = map.printJsonTo(out);
+  TEST_ASSERT_EQUAL_STRING("{\"nim\":\"123\",\"nama\":\"Budi\"}", out.c_str());
+  TEST_ASSERT_EQUAL(written, map.measureJsonLength());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_foreach_visits_key_order);
+  RUN_TEST(test_c_string_keys_compare_text);
+  RUN_TEST(test_lookup_update_and_remove);
+  RUN_TEST(test_lookup_matches_hashmap);
+  RUN_TEST(test_column_keys_print_names);
+  return UNITY_END();
+}
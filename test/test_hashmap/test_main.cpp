@@ -0,0 +1,278 @@
+#include <HashMap.h>
+#include <StreamString.h>
+#include <Tracked.h>
+#include <unity.h>
+
+void setUp() { Tracked::copies = 0; }
+void tearDown() {}
+
+void test_put_get_and_update() {
+  HashMap<String, String> map;
+  map.put("nim", "123");
+  map.put("nama", "Budi");
+  map.update("nim", "456");
+  map.put("nama", "Siti");
+
+  TEST_ASSERT_EQUAL(2, map.size());
+  TEST_ASSERT_EQUAL_STRING("456", map.get("nim").c_str());
+  TEST_ASSERT_EQUAL_STRING("Siti", map.get("nama").c_str());
+}
+
+void test_missing_keys() {
+  HashMap<String, int> map;
+  map.put("present", 1);
+
+  TEST_ASSERT_EQUAL(0, map.get("missing"));
+  TEST_ASSERT_EQUAL(7, map.getOrDefault("missing", 7));
+  TEST_ASSERT_NULL(map.find("missing"));
+  TEST_ASSERT_FALSE(map.containsKey("missing"));
+  TEST_ASSERT_TRUE(map.containsKey("present"));
+  TEST_ASSERT_TRUE(map.containsValue(1));
+  TEST_ASSERT_FALSE(map.containsValue(2));
+}
+
+void test_find_changes_value_in_place() {
+  HashMap<String, int> map;
+  map.put("taps", 1);
+
+  int *taps = map.find("taps");
+  TEST_ASSERT_NOT_NULL(taps);
+  (*taps)++;
+
+  TEST_ASSERT_EQUAL(2, map.get("taps"));
+}
+
+void test_remove() {
+  HashMap<int, int> map;
+  for (int i = 0; i < 20; i++) {
+    map.put(i, i * 10);
+  }
+
+  TEST_ASSERT_TRUE(map.remove(0));
+  TEST_ASSERT_TRUE(map.remove(19));
+  TEST_ASSERT_TRUE(map.remove(7));
+  TEST_ASSERT_FALSE(map.remove(7));
+
+  TEST_ASSERT_EQUAL(17, map.size());
+  TEST_ASSERT_FALSE(map.containsKey(7));
+  TEST_ASSERT_EQUAL(80, map.get(8));
+}
+
+void test_foreach_visits_insertion_order() {
+  HashMap<String, int> map;
+  const char *keys[] = {"uid", "nim", "nama", "divisi", "role"};
+  for (int i = 0; i < 5; i++) {
+    map.put(keys[i], i);
+  }
+  map.remove("nama");
+  map.put("nama", 9);
+
+  const char *expected[] = {"uid", "nim", "divisi", "role", "nama"};
+  size_t index = 0;
+  map.foreach ([&index, &expected](const String &key, const int &) {
+    TEST_ASSERT_EQUAL_STRING(expected[index], key.c_str());
+    index++;
+  });
+  TEST_ASSERT_EQUAL(5, index);
+}
+
+void test_foreach_from_resumes_walk() {
+  HashMap<int, int> map;
+  for (int i = 0; i < 10; i++) {
+    map.put(i, i * 10);
+  }
+
+  HashMap<int, int>::Cursor cursor = map.cursor();
+  int visited = 0;
+  map.foreachFrom(cursor, [&visited](const int &key, const int &) {
+    if (key == 4)
+      return false;
+    visited++;
+    return true;
+  });
+  TEST_ASSERT_EQUAL(4, visited);
+
+  // The walk picks up at the entry it stopped at
+  map.foreachFrom(cursor, [&visited](const int &key, const int &value) {
+    TEST_ASSERT_EQUAL(visited, key);
+    TEST_ASSERT_EQUAL(key * 10, value);
+    visited++;
+    return true;
+  });
+  TEST_ASSERT_EQUAL(10, visited);
+  TEST_ASSERT_NULL(cursor);
+}
+
+void test_clear_and_reuse() {
+  HashMap<String, String> map;
+  map.put("a", "1");
+  map.put("b", "2");
+  map.clear();
+
+  TEST_ASSERT_TRUE(map.isEmpty());
+  TEST_ASSERT_EQUAL(0, map.size());
+  TEST_ASSERT_FALSE(map.containsKey("a"));
+
+  map.put("c", "3");
+  TEST_ASSERT_EQUAL_STRING("3", map.get("c").c_str());
+}
+
+void test_copy_is_independent() {
+  HashMap<String, String> map;
+  map.put("a", "1");
+
+  HashMap<String, String> copy(map);
+  copy.put("a", "changed");
+  copy.put("b", "2");
+
+  TEST_ASSERT_EQUAL(1, map.size());
+  TEST_ASSERT_EQUAL_STRING("1", map.get("a").c_str());
+  TEST_ASSERT_EQUAL(2, copy.size());
+}
+
+void test_print_json() {
+  HashMap<String, int> map;
+  map.put("hadir", 12);
+  map.put("izin", 3);
+
+  HashMap<int, String> byNumber;
+  byNumber.put(1, "satu");
+
+  StreamString out;
+  size_t written = map.printJsonTo(out);
+  TEST_ASSERT_EQUAL_STRING("{\"hadir\":12,\"izin\":3}", out.c_str());
+  TEST_ASSERT_EQUAL(written, map.measureJsonLength());
+
+  StreamString numbered;
+  byNumber.printJsonTo(numbered);
+  TEST_ASSERT_EQUAL_STRING("{\"1\":\"satu\"}", numbered.c_str());
+}
+
+void test_integer_hash_spreads_low_bits() {
+  // Multiples of 1024 share their low 10 bits, the buckets are picked by
+  // the low bits of the hash
+  Hash<int> hasher;
+  bool isUsed[16] = {};
+  size_t usedBuckets = 0;
+  for (int i = 0; i < 64; i++) {
+    uint32_t bucket = hasher(i * 1024) & 15;
+    if (!isUsed[bucket]) {
+      isUsed[bucket] = true;
+      usedBuckets++;
+    }
+  }
+
+  TEST_ASSERT_GREATER_OR_EQUAL(12, usedBuckets);
+}
+
+/**
+ * @brief A hasher with a seed, so a map only finds keys hashed with the
+ * same seed.
+ */
+struct SeededHash {
+  uint32_t seed = 0;
+  uint32_t operator()(int key) const { return fmix32(key ^ seed); }
+};
+
+void test_move_assignment_takes_hasher() {
+  SeededHash hasher;
+  hasher.seed = 0x9E3779B9UL;
+  HashMap<int, int, SeededHash> seeded(hasher);
+  for (int i = 0; i < 50; i++) {
+    seeded.put(i, i);
+  }
+
+  HashMap<int, int, SeededHash> moved;
+  moved = std::move(seeded);
+  TEST_ASSERT_EQUAL(50, moved.size());
+  for (int i = 0; i < 50; i++) {
+    TEST_ASSERT_TRUE(moved.containsKey(i));
+  }
+}
+
+void test_rehash_keeps_entries_and_order() {
+  HashMap<int, int> map;
+  map.put(-1, 7);
+  int *first = map.find(-1);
+
+  // Grow through several rehashes
+  for (int i = 0; i < 1000; i++) {
+    map.put(i * 16, i);
+  }
+
+  TEST_ASSERT_EQUAL(1001, map.size());
+  for (int i = 0; i < 1000; i++) {
+    TEST_ASSERT_EQUAL(i, map.get(i * 16));
+  }
+
+  // Entries are relinked, not moved, so pointers to values stay valid
+  TEST_ASSERT_EQUAL_PTR(first, map.find(-1));
+  TEST_ASSERT_EQUAL(7, *first);
+
+  int expected = -1;
+  map.foreach ([&expected](const int &key, const int &value) {
+    TEST_ASSERT_EQUAL(expected < 0 ? -1 : expected * 16, key);
+    expected++;
+  });
+  TEST_ASSERT_EQUAL(1000, expected);
+}
+
+void test_move_leaves_source_empty() {
+  HashMap<String, String> map;
+  map.put("a", "1");
+  map.put("b", "2");
+
+  HashMap<String, String> moved(std::move(map));
+  TEST_ASSERT_EQUAL(2, moved.size());
+  TEST_ASSERT_EQUAL_STRING("2", moved.get("b").c_str());
+  TEST_ASSERT_EQUAL(0, map.size());
+
+  // A moved-from map can be filled again
+  map.put("c", "3");
+  TEST_ASSERT_EQUAL_STRING("3", map.get("c").c_str());
+
+  map = std::move(moved);
+  TEST_ASSERT_EQUAL(2, map.size());
+  TEST_ASSERT_FALSE(map.containsKey("c"));
+  TEST_ASSERT_EQUAL_STRING("1", map.get("a").c_str());
+  TEST_ASSERT_EQUAL(0, moved.size());
+}
+
+void test_values_are_moved_not_copied() {
+  HashMap<int, Tracked> map;
+  for (int i = 0; i < 100; i++) {
+    Tracked value(i);
+    map.put(i, std::move(value));
+  }
+  map.emplace(100, 100);
+  map.emplace(0, -1);
+
+  TEST_ASSERT_EQUAL(0, Tracked::copies);
+  TEST_ASSERT_EQUAL(101, map.size());
+  TEST_ASSERT_EQUAL(-1, map.find(0)->value);
+  TEST_ASSERT_EQUAL(100, map.find(100)->value);
+
+  HashMap<int, Tracked> moved;
+  moved = std::move(map);
+  TEST_ASSERT_EQUAL(0, Tracked::copies);
+  TEST_ASSERT_EQUAL(50, moved.find(50)->value);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_put_get_and_update);
+  RUN_TEST(test_missing_keys);
+  RUN_TEST(test_find_changes_value_in_place);
+  RUN_TEST(test_remove);
+  RUN_TEST(test_foreach_visits_insertion_order);
+  RUN_TEST(test_foreach_from_resumes_walk);
+  RUN_TEST(test_clear_and_reuse);
+  RUN_TEST(test_copy_is_independent);
+  RUN_TEST(test_print_json);
+  RUN_TEST(test_integer_hash_spreads_low_bits);
+  RUN_TEST(test_move_assignment_takes_hasher);
+  RUN_TEST(test_rehash_keeps_entries_and_order);
+  RUN_TEST(test_move_leaves_source_empty);
+  RUN_TEST(test_values_are_moved_not_copied);
+  return UNITY_END();
+}
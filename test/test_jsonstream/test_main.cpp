@@ -0,0 +1,115 @@
+#include <ArrayList.h>
+#include <HashMap.h>
+#include <StaticMap.h>
+#include <StreamString.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Reads a stream to its end.
+ *
+ * @param stream The stream to read.
+ * @return The bytes read.
+ */
+String readAll(Stream &stream) {
+  String text;
+  for (int c; (c = stream.read()) >= 0;) {
+    text += (char)c;
+  }
+  return text;
+}
+
+/**
+ * @brief Checks that a collection streams the same text it prints.
+ *
+ * @param value The collection to stream.
+ */
+template <typename T> void assertStreamsPrintedText(const T &value) {
+  StreamString printed;
+  printJsonValue(printed, value);
+
+  JsonStream<T> stream(value);
+  TEST_ASSERT_EQUAL(printed.length(), stream.size());
+  TEST_ASSERT_EQUAL(printed.length(), stream.available());
+
+  String text = readAll(stream);
+  TEST_ASSERT_EQUAL_STRING(printed.c_str(), text.c_str());
+  TEST_ASSERT_EQUAL(0, stream.available());
+  TEST_ASSERT_EQUAL(-1, stream.peek());
+}
+
+void test_empty_collections() {
+  assertStreamsPrintedText(ArrayList<int>());
+  assertStreamsPrintedText(HashMap<String, String>());
+}
+
+void test_list_across_windows() {
+  ArrayList<int> numbers;
+  for (int i = 0; i < 500; i++) {
+    numbers.add(i * 37);
+  }
+  assertStreamsPrintedText(numbers);
+}
+
+void test_entries_longer_than_a_window() {
+  ArrayList<String> names;
+  for (int i = 0; i < 10; i++) {
+    String name;
+    for (int j = 0; j < i * 30; j++) {
+      name += (char)('a' + j % 26);
+    }
+    name += "\"\n";
+    names.add(name);
+  }
+  assertStreamsPrintedText(names);
+}
+
+void test_map_across_windows() {
+  HashMap<String, String> columns;
+  for (int i = 0; i < 200; i++) {
+    columns.put("column" + String(i), "value \\ " + String(i * 7));
+  }
+  assertStreamsPrintedText(columns);
+
+  HashMap<int, ArrayList<int>> nested;
+  for (int i = 0; i < 20; i++) {
+    ArrayList<int> items;
+    for (int j = 0; j < i; j++) {
+      items.add(j);
+    }
+    nested.put(i, items);
+  }
+  assertStreamsPrintedText(nested);
+}
+
+void test_static_map() {
+  static constexpr StaticMap<const char *, const char *, 2> data = {{
+      {"nim", "123"},
+      {"nama", "Budi"},
+  }};
+  assertStreamsPrintedText(data);
+}
+
+void test_peek_does_not_advance() {
+  ArrayList<int> numbers;
+  numbers.add(1);
+  JsonStream<ArrayList<int>> stream(numbers);
+
+  TEST_ASSERT_EQUAL('[', stream.peek());
+  TEST_ASSERT_EQUAL('[', stream.read());
+  TEST_ASSERT_EQUAL('1', stream.read());
+  TEST_ASSERT_EQUAL(1, stream.available());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_collections);
+  RUN_TEST(test_list_across_windows);
+  RUN_TEST(test_entries_longer_than_a_window);
+  RUN_TEST(test_map_across_windows);
+  RUN_TEST(test_static_map);
+  RUN_TEST(test_peek_does_not_advance);
+  return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <MemberIndex.h>
+#include <chrono>
+#include <stdio.h>
+#include <unity.h>
+
+// Number of members in the timed roster, above the size of a real roster
+#define TIMED_ROSTER_SIZE 1000
+
+// Longest time a suggestion may take, the target of the companion app
+#define SUGGEST_BUDGET_US 10000
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Makes a member with a name and a card UID.
+ */
+MemberRecord makeMember(const String &name, const String &uid) {
+  MemberRecord member;
+  member.name = name;
+  member.uid = uid;
+  return member;
+}
+
+/**
+ * @brief Makes an index over a small roster, in no particular order.
+ */
+MemberIndex makeIndex() {
+  ArrayList<MemberRecord> roster;
+  roster.add(makeMember("Siti Rahma", "01"));
+  roster.add(makeMember("Budi Santoso", "02"));
+  roster.add(makeMember("Rahmat Hidayat", "03"));
+  roster.add(makeMember("Budiman", "04"));
+  roster.add(makeMember("Andi Budi", "05"));
+  roster.add(makeMember("Rahma", "06"));
+
+  MemberIndex index;
+  index.rebuild(roster);
+  return index;
+}
+
+/**
+ * @brief Joins the names of search results, like "Budi Santoso,Budiman,".
+ */
+String names(const MemberIndex &index, const ArrayList<NameMatch> &matches) {
+  String result;
+  for (size_t i = 0; i < matches.size(); i++) {
+    result += index.get(matches.get(i).slot).name + ",";
+  }
+  return result;
+}
+
+void test_normalize_folds_case_and_spaces() {
+  String normalized = MemberIndex::normalize("  BUDI \t Santoso ");
+  TEST_ASSERT_EQUAL_STRING("budi santoso", normalized.c_str());
+  TEST_ASSERT_EQUAL_STRING("", MemberIndex::normalize(" \n ").c_str());
+}
+
+void test_find_by_name_and_uid() {
+  MemberIndex index = makeIndex();
+  TEST_ASSERT_EQUAL(6, index.size());
+
+  int slot = index.findByName("budi   SANTOSO");
+  TEST_ASSERT_GREATER_OR_EQUAL(0, slot);
+  TEST_ASSERT_EQUAL_STRING("02", index.get(slot).uid.c_str());
+  TEST_ASSERT_EQUAL(-1, index.findByName("Budi"));
+
+  TEST_ASSERT_EQUAL(slot, index.findByUID("02"));
+  TEST_ASSERT_EQUAL(-1, index.findByUID("FF"));
+}
+
+void test_search_prefix_is_alphabetical() {
+  MemberIndex index = makeIndex();
+  TEST_ASSERT_EQUAL_STRING("Budi Santoso,Budiman,",
+                           names(index, index.searchPrefix("bud")).c_str());
+  TEST_ASSERT_EQUAL_STRING("Rahma,Rahmat Hidayat,",
+                           names(index, index.searchPrefix("RAHM")).c_str());
+  TEST_ASSERT_EQUAL_STRING("Budi Santoso,",
+                           names(index, index.searchPrefix("bu", 1)).c_str());
+  TEST_ASSERT_EQUAL(0, index.searchPrefix("zz").size());
+}
+
+void test_suggest_ranks_matches() {
+  MemberIndex index = makeIndex();
+
+  // Exact, then prefix of the name, then prefix of a later word
+  ArrayList<NameMatch> matches = index.suggest("rahma");
+  TEST_ASSERT_EQUAL_STRING("Rahma,Rahmat Hidayat,Siti Rahma,",
+                           names(index, matches).c_str());
+  TEST_ASSERT_EQUAL(0, matches.get(0).score);
+  TEST_ASSERT_EQUAL(1, matches.get(1).score);
+  TEST_ASSERT_EQUAL(2, matches.get(2).score);
+
+  // A misspelt name is still found, ranked after the word matches
+  matches = index.suggest("santsoo");
+  TEST_ASSERT_EQUAL_STRING("Budi Santoso,", names(index, matches).c_str());
+  TEST_ASSERT_GREATER_OR_EQUAL(3, matches.get(0).score);
+
+  // Short queries don't match fuzzily
+  TEST_ASSERT_EQUAL(0, index.suggest("xy").size());
+  TEST_ASSERT_EQUAL(2, index.suggest("budi", 2).size());
+  TEST_ASSERT_EQUAL(0, index.suggest("   ").size());
+}
+
+void test_rebuild_matches_adding_one_by_one() {
+  ArrayList<MemberRecord> roster;
+  MemberIndex added;
+  uint32_t seed = 7;
+  for (int i = 0; i < 300; i++) {
+    seed = seed * 1103515245 + 12345;
+    // Few distinct names, so many members share one
+    MemberRecord member =
+        makeMember("Member " + String((seed >> 16) % 50), String(i));
+    roster.add(member);
+    added.add(member);
+  }
+
+  MemberIndex rebuilt;
+  rebuilt.rebuild(roster);
+  ArrayList<NameMatch> expected = added.searchPrefix("member", 300);
+  ArrayList<NameMatch> actual = rebuilt.searchPrefix("member", 300);
+  TEST_ASSERT_EQUAL(300, actual.size());
+  for (size_t i = 0; i < actual.size(); i++) {
+    TEST_ASSERT_EQUAL(expected.get(i).slot, actual.get(i).slot);
+  }
+}
+
+void test_suggest_within_budget_at_roster_size() {
+  ArrayList<MemberRecord> roster;
+  const char *first[] = {"Budi", "Siti", "Andi", "Rahmat", "Dewi", "Agus"};
+  const char *last[] = {"Santoso", "Rahma", "Hidayat", "Pratama", "Lestari"};
+  for (int i = 0; i < TIMED_ROSTER_SIZE; i++) {
+    roster.add(makeMember(String(first[i % 6]) + " " + last[i / 6 % 5] +
+                              " " + String(i),
+                          String(i)));
+  }
+
+  auto started = std::chrono::steady_clock::now();
+  MemberIndex index;
+  index.rebuild(roster);
+  auto built = std::chrono::steady_clock::now();
+
+  // Every keystroke of a name being typed, misspelt on the way
+  const char *typed[] = {"s", "sa", "san", "sant", "sants", "santso"};
+  long slowest = 0;
+  for (const char *query : typed) {
+    auto queried = std::chrono::steady_clock::now();
+    TEST_ASSERT_GREATER_THAN(0, index.suggest(query).size());
+    long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - queried)
+                       .count();
+    slowest = elapsed > slowest ? elapsed : slowest;
+  }
+
+  char line[120];
+  snprintf(line, sizeof(line),
+           "n=%d rebuild %ld us, slowest suggestion %ld us", TIMED_ROSTER_SIZE,
+           (long)std::chrono::duration_cast<std::chrono::microseconds>(
+               built - started)
+               .count(),
+           slowest);
+  TEST_MESSAGE(line);
+  TEST_ASSERT_LESS_THAN(SUGGEST_BUDGET_US, slowest);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_normalize_folds_case_and_spaces);
+  RUN_TEST(test_find_by_name_and_uid);
+  RUN_TEST(test_search_prefix_is_alphabetical);
+  RUN_TEST(test_suggest_ranks_matches);
+  RUN_TEST(test_rebuild_matches_adding_one_by_one);
+  RUN_TEST(test_suggest_within_budget_at_roster_size);
+  return UNITY_END();
+}
@@ -0,0 +1,90 @@
+#include <Arduino.h>
+#include <RingBuffer.h>
+#include <thread>
+#include <unity.h>
+
+// Number of items passed between the threads, many times the capacity so
+// the indices wrap around the slots over and over
+#define HANDOFF_ITEMS 200000
+
+void setUp() {}
+void tearDown() {}
+
+void test_reports_full_and_empty() {
+  RingBuffer<int, 4> queue;
+  int item = -1;
+  TEST_ASSERT_TRUE(queue.isEmpty());
+  TEST_ASSERT_FALSE(queue.pop(item));
+  TEST_ASSERT_EQUAL(-1, item);
+
+  for (int i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(queue.push(i));
+  }
+  TEST_ASSERT_TRUE(queue.isFull());
+  TEST_ASSERT_EQUAL(4, queue.size());
+  TEST_ASSERT_FALSE(queue.push(4));
+
+  TEST_ASSERT_TRUE(queue.pop(item));
+  TEST_ASSERT_EQUAL(0, item);
+  TEST_ASSERT_EQUAL(3, queue.size());
+}
+
+void test_wraps_around_in_order() {
+  RingBuffer<String, 4> queue;
+  int pushed = 0;
+  int popped = 0;
+
+  // Keep the queue between one and three items deep while the indices
+  // pass the end of the slots many times
+  for (int round = 0; round < 100; round++) {
+    while (queue.size() < 3) {
+      TEST_ASSERT_TRUE(queue.push(String(pushed++)));
+    }
+    while (queue.size() > 1) {
+      String item;
+      TEST_ASSERT_TRUE(queue.pop(item));
+      TEST_ASSERT_EQUAL_STRING(String(popped++).c_str(), item.c_str());
+    }
+  }
+
+  TEST_ASSERT_EQUAL(1, queue.size());
+  TEST_ASSERT_EQUAL(pushed - 1, popped);
+}
+
+void test_hands_items_between_threads() {
+  RingBuffer<uint32_t, 8> queue;
+
+  std::thread producer([&queue] {
+    for (uint32_t i = 0; i < HANDOFF_ITEMS; i++) {
+      while (!queue.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // Every item must arrive exactly once and in order
+  uint32_t expected = 0;
+  bool isOrdered = true;
+  while (expected < HANDOFF_ITEMS) {
+    uint32_t item;
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    isOrdered &= item == expected;
+    expected++;
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(isOrdered);
+  TEST_ASSERT_TRUE(queue.isEmpty());
+  TEST_ASSERT_EQUAL(HANDOFF_ITEMS, expected);
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_reports_full_and_empty);
+  RUN_TEST(test_wraps_around_in_order);
+  RUN_TEST(test_hands_items_between_threads);
+  return UNITY_END();
+}
@@ -0,0 +1,155 @@
+#include <SmallArrayList.h>
+#include <StreamString.h>
+#include <unity.h>
+
+/**
+ * @brief A heap allocator that counts the blocks it allocates.
+ */
+struct CountingAllocator : HeapAllocator {
+  static size_t allocations;
+
+  void *allocate(size_t size) {
+    allocations++;
+    return HeapAllocator::allocate(size);
+  }
+
+  void *reallocate(void *ptr, size_t oldSize, size_t newSize) {
+    allocations++;
+    return HeapAllocator::reallocate(ptr, oldSize, newSize);
+  }
+};
+
+size_t CountingAllocator::allocations = 0;
+
+using Parts = SmallArrayList<String, 4, CountingAllocator>;
+
+void setUp() { CountingAllocator::allocations = 0; }
+void tearDown() {}
+
+/**
+ * @brief Builds a list holding the given number of items.
+ *
+ * @param size The number of items.
+ * @return The list.
+ */
+Parts makeParts(size_t size) {
+  Parts parts;
+  for (size_t i = 0; i < size; i++) {
+    parts.emplace(String((unsigned int)i));
+  }
+  return parts;
+}
+
+void test_stays_inline_up_to_n_items() {
+  Parts parts = makeParts(4);
+
+  TEST_ASSERT_EQUAL(4, parts.size());
+  TEST_ASSERT_EQUAL(4, parts.getCapacity());
+  TEST_ASSERT_EQUAL_STRING("3", parts.get(3).c_str());
+  TEST_ASSERT_EQUAL(0, CountingAllocator::allocations);
+  TEST_ASSERT_TRUE(is_arraylist<Parts>::value);
+}
+
+void test_spills_to_heap_past_n_items() {
+  Parts parts = makeParts(20);
+
+  TEST_ASSERT_EQUAL(20, parts.size());
+  TEST_ASSERT_GREATER_THAN(0, CountingAllocator::allocations);
+  for (size_t i = 0; i < 20; i++) {
+    TEST_ASSERT_EQUAL(i, parts.get(i).toInt());
+  }
+
+  // Shrinking brings the items back into the inline storage
+  while (parts.size() > 2) {
+    parts.remove(parts.size() - 1);
+  }
+  parts.shrinkToFit();
+  TEST_ASSERT_EQUAL(2, parts.size());
+  TEST_ASSERT_EQUAL_STRING("1", parts.get(1).c_str());
+}
+
+void test_move_from_inline_storage() {
+  Parts parts = makeParts(3);
+
+  Parts moved(std::move(parts));
+  TEST_ASSERT_EQUAL(3, moved.size());
+  TEST_ASSERT_EQUAL_STRING("2", moved.get(2).c_str());
+  TEST_ASSERT_EQUAL(0, parts.size());
+
+  // Both lists own their inline storage, and can be filled again
+  parts.add("again");
+  moved.add("more");
+  TEST_ASSERT_EQUAL_STRING("again", parts.get(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("more", moved.get(3).c_str());
+
+  parts = std::move(moved);
+  TEST_ASSERT_EQUAL(4, parts.size());
+  TEST_ASSERT_EQUAL_STRING("0", parts.get(0).c_str());
+  TEST_ASSERT_EQUAL(0, moved.size());
+  TEST_ASSERT_EQUAL(0, CountingAllocator::allocations);
+}
+
+void test_move_from_heap_takes_buffer() {
+  Parts parts = makeParts(10);
+  size_t allocations = CountingAllocator::allocations;
+
+  Parts moved;
+  moved = std::move(parts);
+  TEST_ASSERT_EQUAL(10, moved.size());
+  TEST_ASSERT_EQUAL_STRING("9", moved.get(9).c_str());
+  TEST_ASSERT_EQUAL(0, parts.size());
+  TEST_ASSERT_EQUAL(allocations, CountingAllocator::allocations);
+}
+
+void test_copy_grows_inline() {
+  Parts parts = makeParts(2);
+  Parts copy(parts);
+  copy.add("2");
+  copy.add("3");
+
+  TEST_ASSERT_EQUAL(2, parts.size());
+  TEST_ASSERT_EQUAL(4, copy.size());
+  TEST_ASSERT_EQUAL_STRING("3", copy.get(3).c_str());
+  TEST_ASSERT_EQUAL(0, CountingAllocator::allocations);
+}
+
+void test_trivial_items_resize_in_place() {
+  SmallArrayList<int, 4, CountingAllocator> list;
+  for (int i = 0; i < 4; i++) {
+    list.add(i);
+  }
+  TEST_ASSERT_EQUAL(0, CountingAllocator::allocations);
+
+  for (int i = 4; i < 100; i++) {
+    list.add(i);
+  }
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_EQUAL(i, list.get(i));
+  }
+
+  list.removeIf([](const int &item) { return item >= 3; });
+  list.shrinkToFit();
+  TEST_ASSERT_EQUAL(3, list.size());
+  TEST_ASSERT_EQUAL(2, list.get(2));
+}
+
+void test_print_json() {
+  Parts parts = makeParts(2);
+
+  StreamString out;
+  size_t written = parts.printJsonTo(out);
+  TEST_ASSERT_EQUAL_STRING("[\"0\",\"1\"]", out.c_str());
+  TEST_ASSERT_EQUAL(written, parts.measureJsonLength());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_stays_inline_up_to_n_items);
+  RUN_TEST(test_spills_to_heap_past_n_items);
+  RUN_TEST(test_move_from_inline_storage);
+  RUN_TEST(test_move_from_heap_takes_buffer);
+  RUN_TEST(test_copy_grows_inline);
+  RUN_TEST(test_trivial_items_resize_in_place);
+  RUN_TEST(test_print_json);
+  return UNITY_END();
+}
@@ -0,0 +1,121 @@
+#ifndef MOCKPOSTMANAPI_H
+#define MOCKPOSTMANAPI_H
+
+#include <Arduino.h>
+
+// Import package for Columns (Local)
+#include <Columns.h>
+
+// Import package for Flat Map (Local)
+#include <FlatMap.h>
+
+// Import package for JSON Writer (Local)
+#include <JsonWriter.h>
+
+/**
+ * @brief A local stand-in for PostmanAPI in the host load tests.
+ * It answers the calls the attendance task makes for a tap from a table of
+ * members, after sleeping for the configured round trip, so the load test
+ * sees the same per-request cost as the kiosk does against the server.
+ * Attendance bodies are streamed through JsonStream like the real client
+ * sends them, and the check-ins are counted per card.
+ */
+class MockPostmanAPI {
+  private:
+  // Time every request takes, in milliseconds
+  uint32_t latency;
+  // ID of every known member, by card UID
+  FlatMap<String, String> members;
+  // Number of check-ins created, by card UID
+  FlatMap<String, uint32_t> checkIns;
+  uint32_t requests = 0;
+  // Body of the last create request
+  String lastBody;
+
+  public:
+  /**
+   * @brief Constructor for the MockPostmanAPI class.
+   *
+   * @param latencyMs The time every request takes, in milliseconds.
+   */
+  MockPostmanAPI(uint32_t latencyMs) : latency(latencyMs) {}
+
+  /**
+   * @brief Adds a member the lookups will find.
+   *
+   * @param cardUID The UID of the member's card, like "0A 1B 2C 3D".
+   * @param id The ID of the member.
+   */
+  void addMember(const String &cardUID, const String &id) {
+    members.put(cardUID, id);
+  }
+
+  /**
+   * @brief Looks a member up by their card UID, like
+   * PostmanAPI::getMemberByUID.
+   *
+   * @param gateway The API endpoint, unused.
+   * @param cardUID The UID of the card to search for.
+   * @return A new String holding the member ID if found, nullptr otherwise.
+   * The caller deletes it.
+   */
+  String *getMemberByUID(String gateway, String cardUID) {
+    delay(latency);
+    requests++;
+
+    const String *id = members.find(cardUID);
+    return id != nullptr ? new String(*id) : nullptr;
+  }
+
+  /**
+   * @brief Creates a row from a map of columns, like PostmanAPI::createData.
+   * The body is streamed the way HTTPClient reads it.
+   *
+   * @param gateway The API endpoint, unused.
+   * @param data The columns of the row, with the card UID under
+   * Column::UID.
+   * @return True if the row was created, false if the card is unknown.
+   */
+  template <typename Map> bool createData(String gateway, const Map &data) {
+    delay(latency);
+    requests++;
+
+    JsonStream<Map> body(data);
+    lastBody = "";
+    for (int c = body.read(); c >= 0; c = body.read()) {
+      lastBody += (char)c;
+    }
+
+    String cardUID = data.get(Column::UID);
+    if (!members.containsKey(cardUID))
+      return false;
+    checkIns.put(cardUID, checkIns.get(cardUID) + 1);
+    return true;
+  }
+
+  /**
+   * @brief Gets the number of requests answered so far.
+   *
+   * @return The number of requests.
+   */
+  uint32_t getRequests() const { return requests; }
+
+  /**
+   * @brief Gets the number of check-ins created for a card.
+   *
+   * @param cardUID The UID of the card.
+   * @return The number of check-ins.
+   */
+  uint32_t getCheckIns(const String &cardUID) const {
+    return checkIns.get(cardUID);
+  }
+
+  /**
+   * @brief Gets the JSON body of the last create request.
+   *
+   * @return The body.
+   */
+  String getLastBody() const { return lastBody; }
+};
+
+#endif
@@ -0,0 +1,264 @@
+// Host load test of the attendance pipeline. Every profile generates a
+// replay script at its tap rate, and runs it through the same stages as the
+// kiosk: a reader thread waits on a ReplayCardSource, debounces the cards and
+// queues them in a RingBuffer, and an attendance thread checks every tap in
+// against MockPostmanAPI. The taps that were processed, debounced and dropped
+// are reported through TEST_MESSAGE, together with the end-to-end latency
+// percentiles, like the replay report of the firmware.
+
+#include "MockPostmanAPI.h"
+#include <RingBuffer.h>
+#include <StreamString.h>
+#include <TapPipeline.h>
+#include <TapReplay.h>
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief A load driven through the pipeline.
+ */
+struct LoadProfile {
+  const char *name;
+  uint32_t tapsPerMinute;
+  uint32_t taps;
+  // Number of distinct cards, tapped in turn
+  uint32_t cards;
+  // Time every request to the mock API takes
+  uint32_t apiLatency;
+};
+
+/**
+ * @brief What became of the taps of a load.
+ */
+struct LoadResult {
+  uint32_t replayed;
+  uint32_t processed;
+  uint32_t debounced;
+  uint32_t dropped;
+  uint32_t checkIns;
+  uint32_t parseFailures;
+  uint32_t maxLag;
+  TapLatencyStats latency;
+};
+
+/**
+ * @brief Formats the UID of the n-th card of a load, like "00 00 00 2A".
+ *
+ * @param card The number of the card.
+ * @return The UID.
+ */
+String cardUID(uint32_t card) {
+  char uid[12];
+  snprintf(uid, sizeof(uid), "%02X %02X %02X %02X", (unsigned)(card >> 24),
+           (unsigned)(card >> 16) & 0xFF, (unsigned)(card >> 8) & 0xFF,
+           (unsigned)card & 0xFF);
+  return uid;
+}
+
+/**
+ * @brief Generates the replay script of a load, with its taps evenly spaced
+ * at the tap rate.
+ *
+ * @param profile The load.
+ * @return The script.
+ */
+String makeScript(const LoadProfile &profile) {
+  String script = "# " + String(profile.name) + "\n";
+  for (uint32_t i = 0; i < profile.taps; i++) {
+    uint32_t offset = (uint64_t)i * 60000 / profile.tapsPerMinute;
+    script += String(offset) + " " + cardUID(i % profile.cards) + "\n";
+  }
+  return script + "END\n";
+}
+
+/**
+ * @brief Replays a load through the reader and attendance stages.
+ * The reader thread follows TaskCardReader and the attendance thread
+ * follows TaskAttendance, without the display and the menus.
+ *
+ * @param profile The load.
+ * @return What became of its taps.
+ */
+LoadResult runLoad(const LoadProfile &profile) {
+  MockPostmanAPI api(profile.apiLatency);
+  for (uint32_t card = 0; card < profile.cards; card++) {
+    api.addMember(cardUID(card), String(1000 + card));
+  }
+
+  StreamString script;
+  script += makeScript(profile);
+  ReplayCardSource source;
+  source.begin();
+  source.setScript(script);
+
+  TapDebouncer debouncer(TAP_DEBOUNCE_WINDOW);
+  RingBuffer<TapEvent, TAP_QUEUE_SIZE> queue;
+  std::atomic<uint32_t> debounced(0);
+  std::atomic<uint32_t> dropped(0);
+  std::atomic<bool> isFinished(false);
+
+  std::thread reader([&] {
+    while (!source.takeFinished()) {
+      TapEvent cards[CARD_INVENTORY_SIZE];
+      size_t cardCount = 0;
+      if (source.waitForCard(CARD_WAIT_TIMEOUT))
+        cardCount = source.readCards(cards, CARD_INVENTORY_SIZE);
+
+      uint32_t tappedAt = millis();
+      for (size_t i = 0; i < cardCount; i++) {
+        if (!debouncer.accept(cards[i].uid, tappedAt)) {
+          debounced++;
+          continue;
+        }
+
+        cards[i].tappedAt = tappedAt;
+        if (!queue.push(cards[i]))
+          dropped++;
+      }
+    }
+    isFinished = true;
+  });
+
+  LoadResult result = {};
+  for (;;) {
+    TapEvent event;
+    if (!queue.pop(event)) {
+      if (isFinished && queue.isEmpty())
+        break;
+      delay(1);
+      continue;
+    }
+
+    // The lookup and the check-in of memberAttendance
+    String uid = event.uid.toString();
+    String *memberID = api.getMemberByUID("/api/mahasiswa", uid);
+    if (memberID != nullptr) {
+      delete memberID;
+
+      FlatMap<Column, String> attendanceData;
+      attendanceData.put(Column::UID, uid);
+      attendanceData.put(Column::ROLE, "PESERTA");
+      api.createData("/api/log/masuk", attendanceData);
+    }
+    result.latency.record(millis() - event.tappedAt);
+  }
+  reader.join();
+
+  result.replayed = source.getReplayed();
+  result.processed = result.latency.getCount();
+  result.debounced = debounced;
+  result.dropped = dropped;
+  result.parseFailures = source.takeParseFailures();
+  result.maxLag = source.getMaxLag();
+  for (uint32_t card = 0; card < profile.cards; card++) {
+    result.checkIns += api.getCheckIns(cardUID(card));
+  }
+  return result;
+}
+
+/**
+ * @brief Reports the result of a load, like printReplayReport.
+ *
+ * @param profile The load.
+ * @param result What became of its taps.
+ */
+void report(const LoadProfile &profile, const LoadResult &result) {
+  char line[200];
+  snprintf(line, sizeof(line),
+           "%-9s %5u taps/min: %u replayed, %u processed, %u debounced, "
+           "%u dropped | p50 %u ms, p90 %u ms, p99 %u ms, max %u ms | "
+           "lag %u ms",
+           profile.name, profile.tapsPerMinute, result.replayed,
+           result.processed, result.debounced, result.dropped,
+           result.latency.percentile(50), result.latency.percentile(90),
+           result.latency.percentile(99), result.latency.getMax(),
+           result.maxLag);
+  TEST_MESSAGE(line);
+}
+
+/**
+ * @brief Checks that every tap of a load is accounted for.
+ *
+ * @param profile The load.
+ * @param result What became of its taps.
+ */
+void assertAccounted(const LoadProfile &profile, const LoadResult &result) {
+  TEST_ASSERT_EQUAL(profile.taps, result.replayed);
+  TEST_ASSERT_EQUAL(result.replayed,
+                    result.processed + result.debounced + result.dropped);
+  TEST_ASSERT_EQUAL(result.processed, result.checkIns);
+  TEST_ASSERT_EQUAL(0, result.parseFailures);
+}
+
+void test_steady_load_keeps_up() {
+  // A tap every 100 ms, each processed in two 10 ms requests
+  LoadProfile profile = {"steady", 600, 20, 20, 10};
+  LoadResult result = runLoad(profile);
+  report(profile, result);
+  assertAccounted(profile, result);
+
+  TEST_ASSERT_EQUAL(profile.taps, result.processed);
+  TEST_ASSERT_EQUAL(0, result.dropped);
+  TEST_ASSERT_GREATER_OR_EQUAL(2 * profile.apiLatency,
+                               result.latency.percentile(50));
+  // Taps don't wait for each other, so none waits for a whole interval
+  TEST_ASSERT_LESS_THAN(100, result.latency.percentile(99));
+}
+
+void test_repeated_cards_are_debounced() {
+  // Five cards tapped in turn every 50 ms, each again within the window
+  LoadProfile profile = {"repeats", 1200, 20, 5, 5};
+  LoadResult result = runLoad(profile);
+  report(profile, result);
+  assertAccounted(profile, result);
+
+  TEST_ASSERT_EQUAL(profile.cards, result.processed);
+  TEST_ASSERT_EQUAL(profile.taps - profile.cards, result.debounced);
+  TEST_ASSERT_EQUAL(0, result.dropped);
+}
+
+void test_overload_drops_taps() {
+  // A tap every 10 ms, while each takes 50 ms, so the queue fills up
+  LoadProfile profile = {"overload", 6000, 60, 60, 25};
+  LoadResult result = runLoad(profile);
+  report(profile, result);
+  assertAccounted(profile, result);
+
+  TEST_ASSERT_GREATER_THAN(0, result.dropped);
+  TEST_ASSERT_GREATER_OR_EQUAL(TAP_QUEUE_SIZE, result.processed);
+  // The last taps waited behind a full queue, two requests per tap
+  TEST_ASSERT_GREATER_OR_EQUAL(TAP_QUEUE_SIZE * profile.apiLatency,
+                               result.latency.getMax());
+}
+
+void test_check_in_body_names_columns() {
+  MockPostmanAPI api(0);
+  api.addMember("0A 1B", "7");
+
+  FlatMap<Column, String> attendanceData;
+  attendanceData.put(Column::UID, "0A 1B");
+  attendanceData.put(Column::ROLE, "PESERTA");
+  TEST_ASSERT_TRUE(api.createData("/api/log/masuk", attendanceData));
+  TEST_ASSERT_EQUAL_STRING("{\"uid\":\"0A 1B\",\"role\":\"PESERTA\"}",
+                           api.getLastBody().c_str());
+  TEST_ASSERT_EQUAL(1, api.getCheckIns("0A 1B"));
+
+  attendanceData.put(Column::UID, "FF");
+  TEST_ASSERT_FALSE(api.createData("/api/log/masuk", attendanceData));
+  TEST_ASSERT_NULL(api.getMemberByUID("/api/mahasiswa", "FF"));
+  TEST_ASSERT_EQUAL(3, api.getRequests());
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_check_in_body_names_columns);
+  RUN_TEST(test_steady_load_keeps_up);
+  RUN_TEST(test_repeated_cards_are_debounced);
+  RUN_TEST(test_overload_drops_taps);
+  return UNITY_END();
+}
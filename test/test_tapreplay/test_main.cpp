@@ -0,0 +1,163 @@
+#include <StreamString.h>
+#include <TapReplay.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Reads the next card of a source as text, like "0A 1B".
+ */
+String readUID(CardSource &source) {
+  CardUID uid;
+  return source.readCard(uid) ? uid.toString() : String("none");
+}
+
+void test_script_taps_are_released_on_time() {
+  StreamString script("# Two taps\n"
+                      "\n"
+                      "0 0A 1B\n"
+                      "150 0c 0d\n"
+                      "END\n");
+  ReplayCardSource source;
+  source.setScript(script);
+
+  uint32_t started = millis();
+  TEST_ASSERT_TRUE(source.waitForCard(50));
+  TEST_ASSERT_EQUAL_STRING("0A 1B", readUID(source).c_str());
+
+  // The second tap isn't due yet
+  TEST_ASSERT_FALSE(source.waitForCard(20));
+  TEST_ASSERT_FALSE(source.takeFinished());
+
+  TEST_ASSERT_TRUE(source.waitForCard(1000));
+  TEST_ASSERT_GREATER_OR_EQUAL(150, millis() - started);
+  TEST_ASSERT_EQUAL_STRING("0C 0D", readUID(source).c_str());
+
+  TEST_ASSERT_EQUAL(2, source.getReplayed());
+  TEST_ASSERT_LESS_THAN(100, source.getMaxLag());
+  TEST_ASSERT_EQUAL(0, source.takeParseFailures());
+
+  // The end is reported once
+  TEST_ASSERT_TRUE(source.takeFinished());
+  TEST_ASSERT_FALSE(source.takeFinished());
+}
+
+void test_end_line_ends_replay() {
+  ReplayCardSource source;
+  TEST_ASSERT_TRUE(source.schedule("0 01 02"));
+  TEST_ASSERT_TRUE(source.waitForCard(50));
+
+  // Not finished before the END line, nor before the tap was read
+  TEST_ASSERT_FALSE(source.takeFinished());
+  TEST_ASSERT_TRUE(source.schedule("END"));
+  TEST_ASSERT_FALSE(source.takeFinished());
+  TEST_ASSERT_EQUAL_STRING("01 02", readUID(source).c_str());
+  TEST_ASSERT_TRUE(source.takeFinished());
+
+  // The next tap starts a new replay with fresh counters
+  TEST_ASSERT_TRUE(source.schedule("0 03"));
+  TEST_ASSERT_EQUAL(0, source.getReplayed());
+  TEST_ASSERT_TRUE(source.waitForCard(50));
+  TEST_ASSERT_EQUAL(1, source.getReplayed());
+  TEST_ASSERT_EQUAL_STRING("03", readUID(source).c_str());
+}
+
+void test_malformed_lines_are_counted() {
+  ReplayCardSource source;
+  const char *malformed[] = {
+      "tap 0A",                                // No time
+      "10 GG",                                 // Not hex
+      "10 1FF",                                // Not a byte
+      "10",                                    // No UID
+      "10 01 02 03 04 05 06 07 08 09 0A 0B",   // UID too long
+  };
+  for (const char *line : malformed) {
+    TEST_ASSERT_FALSE(source.schedule(line));
+  }
+  TEST_ASSERT_TRUE(source.schedule("  5   0a  1b "));
+  TEST_ASSERT_TRUE(source.schedule("# comment"));
+  TEST_ASSERT_TRUE(source.schedule(""));
+
+  TEST_ASSERT_EQUAL(5, source.takeParseFailures());
+  TEST_ASSERT_EQUAL(0, source.takeParseFailures());
+
+  TEST_ASSERT_TRUE(source.waitForCard(100));
+  TEST_ASSERT_EQUAL_STRING("0A 1B", readUID(source).c_str());
+}
+
+void test_overlong_line_is_dropped() {
+  // One line longer than the buffer, whose rest would read as a tap of
+  // card 0E, then one that fills the buffer exactly
+  String overlong = "0";
+  for (int i = 0; i < 20; i++) {
+    overlong += " AA";
+  }
+  overlong += " 05 0E";
+  String exact = "0 0C";
+  while (exact.length() < REPLAY_LINE_SIZE - 1) {
+    exact += ' ';
+  }
+
+  StreamString script;
+  script += overlong + "\n0 0B\n" + exact + "\n0 0D";
+  ReplayCardSource source;
+  source.setScript(script);
+
+  String read;
+  while (source.waitForCard(50)) {
+    read += readUID(source) + ",";
+  }
+
+  // The rest of the overlong line isn't taken for a tap of its own
+  TEST_ASSERT_EQUAL_STRING("0B,0C,0D,", read.c_str());
+  TEST_ASSERT_EQUAL(1, source.takeParseFailures());
+}
+
+void test_latency_percentiles() {
+  TapLatencyStats stats;
+  TEST_ASSERT_EQUAL(0, stats.percentile(50));
+
+  // Recorded out of order, the percentiles sort them
+  for (uint32_t i = 0; i < 100; i++) {
+    stats.record((i * 37) % 100 + 1);
+  }
+  TEST_ASSERT_EQUAL(100, stats.getCount());
+  TEST_ASSERT_EQUAL(1, stats.percentile(1));
+  TEST_ASSERT_EQUAL(50, stats.percentile(50));
+  TEST_ASSERT_EQUAL(90, stats.percentile(90));
+  TEST_ASSERT_EQUAL(99, stats.percentile(99));
+  TEST_ASSERT_EQUAL(100, stats.percentile(100));
+  TEST_ASSERT_EQUAL(100, stats.getMax());
+}
+
+void test_latency_percentiles_use_recent_samples() {
+  TapLatencyStats stats;
+  for (int i = 0; i < 44; i++) {
+    stats.record(100000);
+  }
+  for (uint32_t i = 1; i <= TAP_LATENCY_SAMPLES; i++) {
+    stats.record(i);
+  }
+
+  // Only the last samples are ranked, the maximum covers every tap
+  TEST_ASSERT_EQUAL(44 + TAP_LATENCY_SAMPLES, stats.getCount());
+  TEST_ASSERT_EQUAL(TAP_LATENCY_SAMPLES / 2, stats.percentile(50));
+  TEST_ASSERT_EQUAL(TAP_LATENCY_SAMPLES, stats.percentile(100));
+  TEST_ASSERT_EQUAL(100000, stats.getMax());
+
+  stats.reset();
+  TEST_ASSERT_EQUAL(0, stats.getCount());
+  TEST_ASSERT_EQUAL(0, stats.percentile(99));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_script_taps_are_released_on_time);
+  RUN_TEST(test_end_line_ends_replay);
+  RUN_TEST(test_malformed_lines_are_counted);
+  RUN_TEST(test_overlong_line_is_dropped);
+  RUN_TEST(test_latency_percentiles);
+  RUN_TEST(test_latency_percentiles_use_recent_samples);
+  return UNITY_END();
+}